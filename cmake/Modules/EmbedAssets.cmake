@@ -0,0 +1,74 @@
+# - Compile asset files into the executable as byte arrays
+#
+#  include(EmbedAssets)
+#  embed_assets(<output.cpp>)
+#
+# Adds a build step generating <output.cpp>, which defines
+# EmbeddedAssets::Table (see src/embedded_assets.hpp) with one
+# null-terminated array per file matching EMBEDDED_ASSET_PATTERNS.
+# The step re-runs whenever one of those files changes; add the
+# output to the executable's sources. Files added later are picked
+# up by the next build on CMake 3.12 and newer (CONFIGURE_DEPENDS),
+# and only once cmake is re-run on older versions. When run as a script
+# (cmake -DSOURCE_DIR=<dir> -DOUTPUT=<file> -P EmbedAssets.cmake)
+# it performs the generation itself.
+
+# Assets compiled into the executable, relative to the source directory
+set(EMBEDDED_ASSET_PATTERNS
+	shaders/*.vert
+	shaders/*.frag
+	assets/levels/*.lvl
+	assets/levels/*.blvl
+	assets/fonts/*.ttf
+)
+
+if(CMAKE_SCRIPT_MODE_FILE)
+	# Patterns are matched in SOURCE_DIR, not in the directory the build runs the script from
+	set(_patterns "")
+	foreach(_pattern ${EMBEDDED_ASSET_PATTERNS})
+		list(APPEND _patterns "${SOURCE_DIR}/${_pattern}")
+	endforeach()
+	file(GLOB _files RELATIVE "${SOURCE_DIR}" ${_patterns})
+	list(SORT _files)
+	set(_content "// Generated by cmake/Modules/EmbedAssets.cmake from the files below; do not edit\n#include \"src/embedded_assets.hpp\"\n\n")
+	set(_table "")
+	set(_index 0)
+	foreach(_file ${_files})
+		file(READ "${SOURCE_DIR}/${_file}" _hex HEX)
+		string(LENGTH "${_hex}" _length)
+		math(EXPR _size "${_length} / 2")
+		string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," _bytes "${_hex}")
+		string(REGEX REPLACE "(0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,)" "\\1\n" _bytes "${_bytes}")
+		string(APPEND _content "// ${_file}\nalignas(16) static constexpr unsigned char asset${_index}[] = {\n${_bytes}0x00\n};\n")
+		string(APPEND _table "    { \"${_file}\", asset${_index}, ${_size} },\n")
+		math(EXPR _index "${_index} + 1")
+	endforeach()
+	string(APPEND _content "\nconst EmbeddedAsset EmbeddedAssets::Table[] = {\n${_table}    { nullptr, nullptr, 0 }\n};\n")
+	# Only touch the output when it changes, so unrelated asset edits don't force a relink
+	if(EXISTS "${OUTPUT}")
+		file(READ "${OUTPUT}" _existing)
+	endif()
+	if(NOT "${_existing}" STREQUAL "${_content}")
+		file(WRITE "${OUTPUT}" "${_content}")
+	endif()
+else()
+	set(_EMBED_ASSETS_SCRIPT "${CMAKE_CURRENT_LIST_FILE}")
+	function(embed_assets _output)
+		set(_patterns "")
+		foreach(_pattern ${EMBEDDED_ASSET_PATTERNS})
+			list(APPEND _patterns "${CMAKE_SOURCE_DIR}/${_pattern}")
+		endforeach()
+		# Re-glob on every build where supported, so new assets are embedded without re-running cmake
+		if(NOT CMAKE_VERSION VERSION_LESS 3.12)
+			file(GLOB _files CONFIGURE_DEPENDS ${_patterns})
+		else()
+			file(GLOB _files ${_patterns})
+		endif()
+		add_custom_command(
+			OUTPUT "${_output}"
+			COMMAND ${CMAKE_COMMAND} -DSOURCE_DIR=${CMAKE_SOURCE_DIR} -DOUTPUT=${_output} -P "${_EMBED_ASSETS_SCRIPT}"
+			DEPENDS ${_files} "${_EMBED_ASSETS_SCRIPT}"
+			COMMENT "Embedding assets"
+		)
+	endfunction()
+endif()
@@ -1,17 +1,21 @@
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+layout (location = 1) in vec4 rect;   // Per instance: <vec2 offset, vec2 scale>
+layout (location = 2) in vec4 tint;   // Per instance: particle color
 
 out vec2 TexCoords;
 out vec4 ParticleColor;
 
-uniform mat4 projection;
-uniform vec2 offset;
-uniform vec4 color;
+layout (std140) uniform Frame
+{
+    mat4  projection;
+    mat4  view;
+    float time;
+};
 
 void main()
 {
-    float scale = 10.0f;
     TexCoords = vertex.zw;
-    ParticleColor = color;
-    gl_Position = projection * vec4((vertex.xy * scale) + offset, 0.0, 1.0);
+    ParticleColor = tint;
+    gl_Position = projection * view * vec4((vertex.xy * rect.zw) + rect.xy, 0.0, 1.0);
 }
\ No newline at end of file
@@ -1,44 +1,59 @@
 #version 330 core
+// Compiled once per effect combination; CHAOS, CONFUSE and SHAKE are defined by PostProcessor
 in  vec2  TexCoords;
 out vec4  color;
   
 uniform sampler2D scene;
-uniform vec2      offsets[9];
-uniform int       edge_kernel[9];
-uniform float     blur_kernel[9];
+uniform vec2      uvScale; // Part of the scene texture the scene was rendered to (dynamic resolution)
 
-uniform bool chaos;
-uniform bool confuse;
-uniform bool shake;
+// Samples the rendered part of the scene, repeating it like GL_REPEAT would the whole texture
+vec4 sceneAt(vec2 uv)
+{
+    return texture(scene, fract(uv) * uvScale);
+}
+
+#if defined(CHAOS) || (defined(SHAKE) && !defined(CONFUSE))
+const float offset = 1.0 / 300.0;
+const vec2 offsets[9] = vec2[](
+    vec2(-offset,  offset), // top-left
+    vec2( 0.0,     offset), // top-center
+    vec2( offset,  offset), // top-right
+    vec2(-offset,  0.0),    // center-left
+    vec2( 0.0,     0.0),    // center-center
+    vec2( offset,  0.0),    // center-right
+    vec2(-offset, -offset), // bottom-left
+    vec2( 0.0,    -offset), // bottom-center
+    vec2( offset, -offset)  // bottom-right
+);
+#if defined(CHAOS)
+// Edge detection
+const float kernel[9] = float[](
+    -1.0, -1.0, -1.0,
+    -1.0,  8.0, -1.0,
+    -1.0, -1.0, -1.0
+);
+#else
+// Blur
+const float kernel[9] = float[](
+    1.0 / 16, 2.0 / 16, 1.0 / 16,
+    2.0 / 16, 4.0 / 16, 2.0 / 16,
+    1.0 / 16, 2.0 / 16, 1.0 / 16
+);
+#endif
+#define CONVOLUTION
+#endif
 
 void main()
 {
-    color = vec4(0.0f);
-    vec3 sample[9];
-    // sample from texture offsets if using convolution matrix
-    if(chaos || shake)
-        for(int i = 0; i < 9; i++)
-            sample[i] = vec3(texture(scene, TexCoords.st + offsets[i]));
-
-    // process effects
-    if(chaos)
-    {           
-        for(int i = 0; i < 9; i++)
-            color += vec4(sample[i] * edge_kernel[i], 0.0f);
-        color.a = 1.0f;
-    }
-    else if(confuse)
-    {
-        color = vec4(1.0 - texture(scene, TexCoords).rgb, 1.0);
-    }
-    else if(shake)
-    {
-        for(int i = 0; i < 9; i++)
-            color += vec4(sample[i] * blur_kernel[i], 0.0f);
-        color.a = 1.0f;
-    }
-    else
-    {
-        color =  texture(scene, TexCoords);
-    }
+#if defined(CONVOLUTION)
+    // Chaos takes precedence over confuse, confuse over shake
+    vec3 sum = vec3(0.0);
+    for(int i = 0; i < 9; i++)
+        sum += vec3(sceneAt(TexCoords.st + offsets[i])) * kernel[i];
+    color = vec4(sum, 1.0);
+#elif defined(CONFUSE)
+    color = vec4(1.0 - sceneAt(TexCoords).rgb, 1.0);
+#else
+    color = sceneAt(TexCoords);
+#endif
 }
\ No newline at end of file
@@ -1,13 +1,27 @@
 #version 330 core
-layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+layout (location = 0) in vec4  vertex;   // <vec2 position, vec2 texCoords>
+layout (location = 1) in vec4  rect;     // Per instance: <vec2 position, vec2 size>
+layout (location = 2) in vec4  tint;     // Per instance: sprite color
+layout (location = 3) in float rotation; // Per instance: rotation around the sprite's center
 
 out vec2 TexCoords;
+out vec4 SpriteColor;
 
-uniform mat4 model;
-uniform mat4 projection;
+layout (std140) uniform Frame
+{
+    mat4  projection;
+    mat4  view;
+    float time;
+};
 
 void main()
 {
     TexCoords = vertex.zw;
-    gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
+    SpriteColor = tint;
+    // Scale first, then rotate around the center of the quad and finally translate
+    vec2 local = (vertex.xy - 0.5) * rect.zw;
+    float s = sin(rotation);
+    float c = cos(rotation);
+    local = vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+    gl_Position = projection * view * vec4(rect.xy + 0.5 * rect.zw + local, 0.0, 1.0);
 }
\ No newline at end of file
@@ -2,7 +2,12 @@
 layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
 out vec2 TexCoords;
 
-uniform mat4 projection;
+layout (std140) uniform Frame
+{
+    mat4  projection;
+    mat4  view;
+    float time;
+};
 
 void main()
 {
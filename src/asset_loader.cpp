@@ -0,0 +1,130 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "asset_loader.hpp"
+
+#include <chrono>
+#include <memory>
+
+#include "resource_manager.hpp"
+
+
+AssetLoader::AssetLoader(GLuint threads)
+    : queued(), completed(), pool(threads)
+{
+
+}
+
+void AssetLoader::Queue(Job job, AssetStage stage)
+{
+    ++this->queued[stage];
+    this->pool.Submit([this, job, stage] {
+        Completion completion = job();
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->ready.push_back(std::make_pair(stage, completion));
+        }
+        this->decoded.notify_one();
+    });
+}
+
+void AssetLoader::QueueTexture(const std::string &file, GLboolean alpha, const std::string &name)
+{
+    this->Queue([file, alpha, name] {
+        std::shared_ptr<DecodedImage> image = std::make_shared<DecodedImage>();
+        ResourceManager::DecodeImage(file.c_str(), alpha, *image);
+        return Completion([image, name] { ResourceManager::LoadTexture(*image, name); });
+    });
+}
+
+void AssetLoader::QueueFont(TextRenderer &text, const std::string &font, GLuint fontSize)
+{
+    // Each batch opens the font itself, so the batches rasterise in parallel
+    TextRenderer *renderer = &text;
+    renderer->Characters.clear();
+    for (GLuint batch = 0; batch < FONT_GLYPH_BATCHES; ++batch)
+    {
+        GLuint first = 128 * batch / FONT_GLYPH_BATCHES, last = 128 * (batch + 1) / FONT_GLYPH_BATCHES;
+        this->Queue([renderer, font, fontSize, first, last] {
+            std::shared_ptr<std::vector<GlyphBitmap>> glyphs = std::make_shared<std::vector<GlyphBitmap>>();
+            TextRenderer::Rasterize(font, fontSize, first, last, *glyphs);
+            return Completion([renderer, glyphs] { renderer->Upload(*glyphs); });
+        });
+    }
+}
+
+GLboolean AssetLoader::Update(GLfloat budget)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::pair<AssetStage, Completion> completion;
+    while (this->next(completion, budget <= 0.0f))
+    {
+        completion.second();
+        ++this->completed[completion.first];
+        if (budget > 0.0f && std::chrono::duration<GLfloat>(std::chrono::steady_clock::now() - start).count() >= budget)
+            break; // Leave the rest for the next frame
+    }
+    return this->Done();
+}
+
+GLfloat AssetLoader::Progress() const
+{
+    GLuint total = 0, done = 0;
+    for (GLuint stage = 0; stage < ASSET_STAGES; ++stage)
+    {
+        total += this->queued[stage];
+        done += this->completed[stage];
+    }
+    return total > 0 ? static_cast<GLfloat>(done) / total : 1.0f;
+}
+
+GLboolean AssetLoader::Done() const
+{
+    for (GLuint stage = 0; stage < ASSET_STAGES; ++stage)
+        if (this->completed[stage] < this->queued[stage])
+            return GL_FALSE;
+    return GL_TRUE;
+}
+
+GLboolean AssetLoader::unblocked(AssetStage stage) const
+{
+    for (GLuint earlier = 0; earlier < static_cast<GLuint>(stage); ++earlier)
+        if (this->completed[earlier] < this->queued[earlier])
+            return GL_FALSE;
+    return GL_TRUE;
+}
+
+GLboolean AssetLoader::next(std::pair<AssetStage, Completion> &completion, GLboolean wait)
+{
+    while (!this->Done())
+    {
+        // Completions held back earlier may have become runnable
+        for (std::vector<std::pair<AssetStage, Completion>>::iterator it = this->held.begin(); it != this->held.end(); ++it)
+            if (this->unblocked(it->first))
+            {
+                completion = *it;
+                this->held.erase(it);
+                return GL_TRUE;
+            }
+        // Otherwise take the next decoded asset
+        std::unique_lock<std::mutex> lock(this->mutex);
+        if (this->ready.empty())
+        {
+            if (!wait)
+                return GL_FALSE;
+            this->decoded.wait(lock, [this] { return !this->ready.empty(); });
+        }
+        completion = this->ready.front();
+        this->ready.pop_front();
+        lock.unlock();
+        if (this->unblocked(completion.first))
+            return GL_TRUE;
+        this->held.push_back(completion);
+    }
+    return GL_FALSE;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "thread_pool.hpp"
+#include "text_renderer.hpp"
+
+
+// Stages of loading. Assets of a stage are decoded right away, but
+// only completed once all assets of the earlier stages completed.
+enum AssetStage {
+    ASSET_STAGE_UPLOAD, // GL resources (textures, glyphs)
+    ASSET_STAGE_BUILD,  // Objects referring to GL resources (e.g. game objects copy their textures)
+    ASSET_STAGES
+};
+
+// Number of batches the glyphs of a font are rasterised in (each on its own worker)
+const GLuint FONT_GLYPH_BATCHES = 4;
+
+// AssetLoader decodes assets on a pool of worker threads and hands
+// each result back to the thread owning the OpenGL context, which
+// completes it (uploads it) in Update as results arrive. A job runs
+// on a worker and returns the completion to run on the context
+// thread; all functions must be called from the context thread.
+class AssetLoader
+{
+public:
+    typedef std::function<void()>       Completion;
+    typedef std::function<Completion()> Job;
+    // Constructor (0 threads: one per hardware thread besides the calling one)
+    AssetLoader(GLuint threads = 0);
+    // Queues a job in the given stage
+    void      Queue(Job job, AssetStage stage = ASSET_STAGE_UPLOAD);
+    // Decodes an image and stores it as texture under the given name (see ResourceManager::LoadTexture)
+    void      QueueTexture(const std::string &file, GLboolean alpha, const std::string &name);
+    // Rasterises the first 128 characters of a font and uploads them into the given text renderer
+    void      QueueFont(TextRenderer &text, const std::string &font, GLuint fontSize);
+    // Completes decoded assets until the time budget (in seconds) is used up; a budget of 0 blocks until all assets are loaded. Returns whether all assets are loaded
+    GLboolean Update(GLfloat budget);
+    // Fraction of queued assets completed
+    GLfloat   Progress() const;
+    // Whether all queued assets are completed
+    GLboolean Done() const;
+private:
+    // Loading state (owned by the context thread)
+    GLuint                                     queued[ASSET_STAGES], completed[ASSET_STAGES];
+    std::vector<std::pair<AssetStage, Completion>> held; // Decoded, but an earlier stage is still loading
+    // Decoded assets (shared with the workers)
+    std::mutex                                 mutex;
+    std::condition_variable                    decoded;
+    std::deque<std::pair<AssetStage, Completion>> ready;
+    // Workers; declared last so they are stopped before the state they write to is destroyed
+    ThreadPool                                 pool;
+    // Whether all assets of the stages before the given one are completed
+    GLboolean unblocked(AssetStage stage) const;
+    // Takes the next completion that may run; returns false if there is none (without waiting unless wait is set)
+    GLboolean next(std::pair<AssetStage, Completion> &completion, GLboolean wait);
+};
+
+#endif
\ No newline at end of file
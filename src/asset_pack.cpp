@@ -0,0 +1,103 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "asset_pack.hpp"
+
+#include <cstring>
+#include <iostream>
+#ifdef BREAKOUT_LZ4
+#include <lz4.h>
+#endif
+
+#include "resource_manager.hpp"
+
+
+GLboolean AssetPack::Open(const std::string &path)
+{
+    this->entries = nullptr;
+    this->count = 0;
+    if (!this->file.Open(path))
+        return GL_FALSE;
+    // Check the header and that the index and all data lie within the file
+    const PackHeader *header = reinterpret_cast<const PackHeader*>(this->file.Data);
+    if (this->file.Size < static_cast<GLsizeiptr>(sizeof(PackHeader)) || header->Magic != PACK_MAGIC || header->Version != PACK_VERSION ||
+        static_cast<GLuint64>(this->file.Size) < sizeof(PackHeader) + static_cast<GLuint64>(header->Count) * sizeof(PackEntry))
+    {
+        std::cout << "ERROR::PACK: " << path << " is not an asset pack of version " << PACK_VERSION << std::endl;
+        this->file.Close();
+        return GL_FALSE;
+    }
+    const PackEntry *index = reinterpret_cast<const PackEntry*>(this->file.Data + sizeof(PackHeader));
+    for (GLuint i = 0; i < header->Count; ++i)
+        if (index[i].Offset + index[i].Size + 1 > static_cast<GLuint64>(this->file.Size) || index[i].Path[PACK_PATH_LENGTH - 1] != '\0')
+        {
+            std::cout << "ERROR::PACK: " << path << " is truncated or corrupt" << std::endl;
+            this->file.Close();
+            return GL_FALSE;
+        }
+    this->entries = index;
+    this->count = header->Count;
+    return GL_TRUE;
+}
+
+GLboolean AssetPack::Read(const std::string &path, AssetView &asset) const
+{
+    // Binary search of the sorted index
+    GLuint first = 0, last = this->count;
+    while (first < last)
+    {
+        GLuint middle = (first + last) / 2;
+        int order = std::strcmp(this->entries[middle].Path, path.c_str());
+        if (order == 0)
+        {
+            const PackEntry &entry = this->entries[middle];
+            const unsigned char *data = this->file.Data + entry.Offset;
+            if (entry.Compression == PACK_STORED)
+            {
+                asset.Data = data;
+                asset.Size = static_cast<GLsizeiptr>(entry.Size);
+                asset.Storage.clear();
+                return GL_TRUE;
+            }
+#ifdef BREAKOUT_LZ4
+            if (entry.Compression == PACK_LZ4)
+            {
+                asset.Storage.resize(static_cast<size_t>(entry.OriginalSize) + 1);
+                int size = LZ4_decompress_safe(reinterpret_cast<const char*>(data), reinterpret_cast<char*>(asset.Storage.data()),
+                    static_cast<int>(entry.Size), static_cast<int>(entry.OriginalSize));
+                if (size != static_cast<int>(entry.OriginalSize))
+                {
+                    std::cout << "ERROR::PACK: Failed to decompress " << path << std::endl;
+                    return GL_FALSE;
+                }
+                asset.Storage[entry.OriginalSize] = 0;
+                asset.Data = asset.Storage.data();
+                asset.Size = static_cast<GLsizeiptr>(entry.OriginalSize);
+                return GL_TRUE;
+            }
+#endif
+            std::cout << "ERROR::PACK: Unsupported compression of " << path << " (build with BREAKOUT_LZ4)" << std::endl;
+            return GL_FALSE;
+        }
+        if (order < 0)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+    return GL_FALSE;
+}
+
+GLuint AssetPack::Count() const
+{
+    return this->count;
+}
+
+const char *AssetPack::Path(GLuint index) const
+{
+    return this->entries[index].Path;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+#include <string>
+
+#include <GL/glew.h>
+
+#include "mapped_file.hpp"
+
+
+// Identifies an asset pack ("BPAK")
+const GLuint PACK_MAGIC = 0x4B415042;
+// Version of the pack layout below
+const GLuint PACK_VERSION = 1;
+// Alignment of every entry's data within the pack
+const GLuint PACK_ALIGNMENT = 64;
+// Maximum length of an entry path (including the terminating zero)
+const GLuint PACK_PATH_LENGTH = 112;
+
+// Compression of a pack entry
+enum PackCompression {
+    PACK_STORED, // Data is the asset itself
+    PACK_LZ4     // Data is an LZ4 block decompressing to OriginalSize bytes
+};
+
+// Layout of a pack: the header, Count entries sorted by path, and
+// the data of each entry at its (aligned) offset, followed by a
+// zero byte so text can be used in place.
+struct PackHeader {
+    GLuint Magic;
+    GLuint Version;
+    GLuint Count;
+    GLuint Reserved;
+};
+
+struct PackEntry {
+    char     Path[PACK_PATH_LENGTH]; // Relative to the source tree, e.g. "assets/levels/01_one.lvl"
+    GLuint64 Offset;                 // From the start of the pack
+    GLuint64 Size;                   // Bytes stored in the pack
+    GLuint64 OriginalSize;           // Bytes of the asset (equal to Size unless compressed)
+    GLuint   Compression;            // PackCompression
+    GLuint   Reserved;
+};
+
+struct AssetView;
+
+// AssetPack serves the assets of a pack built by the asset packer
+// tool. The pack is memory-mapped once, and stored entries are
+// returned as views straight into the mapping.
+class AssetPack
+{
+public:
+    // Constructor
+    AssetPack() : entries(nullptr), count(0) { }
+    // Maps the given pack and validates its index; returns false if it isn't a readable pack
+    GLboolean Open(const std::string &path);
+    // Reads the asset at the given path; returns false if the pack does not contain it
+    GLboolean Read(const std::string &path, AssetView &asset) const;
+    // Number of assets in the pack
+    GLuint    Count() const;
+    // Path of the asset at the given index (assets are sorted by path)
+    const char *Path(GLuint index) const;
+private:
+    MappedFile       file;
+    const PackEntry *entries; // Index within the mapping, sorted by path
+    GLuint           count;
+};
+
+#endif
\ No newline at end of file
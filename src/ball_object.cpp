@@ -11,11 +11,11 @@
 BallObject::BallObject()
 	: GameObject(), Radius(12.5f), Stuck(GL_TRUE), Sticky(GL_FALSE), PassThrough(GL_FALSE) { }
 
-BallObject::BallObject(glm::vec2 pos, GLfloat radius, glm::vec2 velocity, Texture2D sprite)
+BallObject::BallObject(glm::vec2 pos, GLfloat radius, glm::vec2 velocity, TextureView sprite)
 	: GameObject(pos, glm::vec2(radius * 2, radius * 2), sprite, glm::vec3(1.0f), velocity), Radius(radius), Stuck(GL_TRUE), Sticky(GL_FALSE), PassThrough(GL_FALSE) { }
 
 
-glm::vec2 BallObject::Move(GLfloat dt, GLuint window_width)
+glm::vec2 BallObject::Move(GLfloat dt, GLuint window_width, GLfloat top)
 {
     // If not stuck to player board
     if (!this->Stuck)
@@ -33,10 +33,10 @@ glm::vec2 BallObject::Move(GLfloat dt, GLuint window_width)
             this->Velocity.x = -this->Velocity.x;
             this->Position.x = window_width - this->Size.x;
         }
-        if (this->Position.y <= 0.0f)
+        if (this->Position.y <= top)
         {
             this->Velocity.y = -this->Velocity.y;
-            this->Position.y = 0.0f;
+            this->Position.y = top;
         }
     }
     return this->Position;
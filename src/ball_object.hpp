@@ -29,9 +29,9 @@ public:
 	GLboolean Sticky, PassThrough;
     // Constructor(s)
     BallObject();
-    BallObject(glm::vec2 pos, GLfloat radius, glm::vec2 velocity, Texture2D sprite);
-    // Moves the ball, keeping it constrained within the window bounds (except bottom edge); returns new position
-    glm::vec2 Move(GLfloat dt, GLuint window_width);
+    BallObject(glm::vec2 pos, GLfloat radius, glm::vec2 velocity, TextureView sprite);
+    // Moves the ball, keeping it constrained within the window bounds (except bottom edge; top is the window's top edge); returns new position
+    glm::vec2 Move(GLfloat dt, GLuint window_width, GLfloat top = 0.0f);
     // Resets the ball to original state with given position, velocity and radius
     void      Reset(glm::vec2 position, glm::vec2 velocity, GLfloat radius);
 	void	  Resize(GLfloat radius);
@@ -0,0 +1,18 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "embedded_assets.hpp"
+
+
+const EmbeddedAsset *EmbeddedAssets::Find(const std::string &path)
+{
+    for (const EmbeddedAsset *asset = Table; asset->Path != nullptr; ++asset)
+        if (path == asset->Path)
+            return asset;
+    return nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef EMBEDDED_ASSETS_H
+#define EMBEDDED_ASSETS_H
+#include <string>
+
+#include <GL/glew.h>
+
+
+// An asset compiled into the executable. Data[Size] is always a
+// terminating zero, so text assets can be used as C strings.
+struct EmbeddedAsset {
+    const char          *Path; // Relative to the source tree, e.g. "shaders/sprite.vert"
+    const unsigned char *Data;
+    GLsizeiptr           Size;
+};
+
+
+// A static singleton EmbeddedAssets class that provides access to
+// the assets compiled into the executable at build time (shaders,
+// levels and the font; see cmake/Modules/EmbedAssets.cmake).
+class EmbeddedAssets
+{
+public:
+    // All embedded assets, terminated by an entry with a null Path (defined in the generated source)
+    static const EmbeddedAsset Table[];
+    // Returns the asset embedded under the given path, nullptr if there is none
+    static const EmbeddedAsset *Find(const std::string &path);
+private:
+    // Private constructor, that is we do not want any actual asset objects. Its members and functions should be publicly available (static).
+    EmbeddedAssets() { }
+};
+
+#endif
\ No newline at end of file
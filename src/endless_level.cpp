@@ -0,0 +1,93 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "endless_level.hpp"
+
+#include <cmath>
+
+#include "game_level.hpp"
+#include "hash.hpp"
+
+
+EndlessLevel::EndlessLevel(GLuint levelWidth, GLfloat rowHeight, GLuint viewHeight, TextureView solid, TextureView block)
+    : levelWidth(levelWidth), viewHeight(viewHeight), rowHeight(rowHeight), solid(solid), block(block), generated(0), bottom(0.0f)
+{
+    // One slot more than the view can show at once: the chunk leaving the view at the bottom is
+    // only recycled once it is out of sight, and by then the others still cover the whole view
+    GLfloat chunkHeight = rowHeight * ENDLESS_CHUNK_ROWS;
+    this->slots = static_cast<GLuint>(std::ceil(viewHeight / chunkHeight)) + 1;
+    glm::vec2 size(levelWidth / static_cast<GLfloat>(ENDLESS_COLUMNS), rowHeight);
+    this->Bricks.resize(this->slots * ENDLESS_CHUNK_ROWS * ENDLESS_COLUMNS, GameObject(glm::vec2(0.0f), size, block));
+    for (GameObject &brick : this->Bricks)
+        brick.Destroyed = GL_TRUE;
+}
+
+void EndlessLevel::Reset(GLfloat startLine)
+{
+    GLfloat chunkHeight = this->rowHeight * ENDLESS_CHUNK_ROWS;
+    this->bottom = startLine - chunkHeight;
+    for (GLuint chunk = 0; chunk < this->slots; ++chunk)
+        this->generate(chunk, this->bottom - chunk * chunkHeight);
+    this->generated = this->slots;
+}
+
+void EndlessLevel::Update(GLfloat scroll)
+{
+    // The oldest chunk is out of sight once its top edge passed the bottom of the view; it becomes the newest one on top
+    GLfloat chunkHeight = this->rowHeight * ENDLESS_CHUNK_ROWS;
+    while (this->bottom >= scroll + this->viewHeight)
+    {
+        this->generate(this->generated, this->bottom - this->slots * chunkHeight);
+        ++this->generated;
+        this->bottom -= chunkHeight;
+    }
+}
+
+void EndlessLevel::Shift(GLfloat offset)
+{
+    this->bottom += offset;
+    for (GameObject &brick : this->Bricks)
+        brick.Position.y += offset;
+}
+
+void EndlessLevel::Draw(RenderQueue &queue)
+{
+    for (GameObject &brick : this->Bricks)
+        if (!brick.Destroyed)
+            brick.Draw(queue, LAYER_LEVEL);
+}
+
+GLuint64 EndlessLevel::Chunks() const
+{
+    return this->generated;
+}
+
+void EndlessLevel::generate(GLuint64 index, GLfloat top)
+{
+    // Each chunk's layout only depends on its number, so every run scrolls through the same playfield
+    GLuint64 state = Fnv1a(&index, sizeof(index)) | 1;
+    GLfloat unit_width = this->levelWidth / static_cast<GLfloat>(ENDLESS_COLUMNS);
+    GameObject *brick = &this->Bricks[(index % this->slots) * ENDLESS_CHUNK_ROWS * ENDLESS_COLUMNS];
+    for (GLuint y = 0; y < ENDLESS_CHUNK_ROWS; ++y)
+    {
+        for (GLuint x = 0; x < ENDLESS_COLUMNS; ++x, ++brick)
+        {
+            // xorshift64; a third of the tiles stays empty, one in twelve is solid and the rest are the level file colors 2 to 5
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            GLuint roll = state % 12;
+            GLubyte code = roll < 4 ? 0 : roll == 4 ? 1 : 2 + roll % 4;
+            brick->Position = glm::vec2(unit_width * x, top + this->rowHeight * y);
+            brick->Destroyed = code == 0;
+            brick->IsSolid = code == 1;
+            brick->Sprite = code == 1 ? this->solid : this->block;
+            brick->Color = GameLevel::TileColor(code);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef ENDLESS_LEVEL_H
+#define ENDLESS_LEVEL_H
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "game_object.hpp"
+#include "render_queue.hpp"
+#include "texture.hpp"
+
+
+// Number of brick columns across the playfield
+const GLuint  ENDLESS_COLUMNS = 15;
+// Height of a brick row
+const GLfloat ENDLESS_ROW_HEIGHT = 30.0f;
+// Number of brick rows generated as one chunk
+const GLuint  ENDLESS_CHUNK_ROWS = 4;
+// Speed (in units per second) the camera scrolls up the playfield
+const GLfloat ENDLESS_SCROLL_SPEED = 15.0f;
+// Scroll distance after which the world is moved back towards the origin (keeps coordinates small for float precision)
+const GLfloat ENDLESS_REBASE_DISTANCE = 4096.0f;
+
+// EndlessLevel is the playfield of the endless mode: an unbounded
+// column of bricks above the start line, generated a chunk of rows
+// at a time as the camera scrolls up. The bricks live in a ring of
+// chunk slots allocated once; a chunk that scrolled out below the
+// view is regenerated in place as the next chunk above the others,
+// so memory and per-frame work don't depend on how long it runs.
+class EndlessLevel
+{
+public:
+    // Level state (every chunk slot's bricks, empty tiles are Destroyed)
+    std::vector<GameObject> Bricks;
+    // Constructor (bricks are sized to fill levelWidth with rows of rowHeight; enough slots are allocated to cover a view of viewHeight)
+    EndlessLevel(GLuint levelWidth, GLfloat rowHeight, GLuint viewHeight, TextureView solid, TextureView block);
+    // Regenerates the chunks above the start line (which lies at startLine, the lower part stays empty)
+    void      Reset(GLfloat startLine);
+    // Recycles the chunks that scrolled below the view whose top edge is at scroll
+    void      Update(GLfloat scroll);
+    // Moves all bricks vertically by offset (see ENDLESS_REBASE_DISTANCE)
+    void      Shift(GLfloat offset);
+    // Render the bricks
+    void      Draw(RenderQueue &queue);
+    // Number of chunks generated since the last reset
+    GLuint64  Chunks() const;
+private:
+    GLuint    levelWidth, viewHeight;
+    GLfloat   rowHeight;
+    TextureView solid, block;
+    GLuint    slots;     // Number of chunk slots in the ring
+    GLuint64  generated; // Number of chunks generated; chunk n lives in slot n % slots
+    GLfloat   bottom;    // Top edge of the lowest (oldest) chunk
+    // Fills the slot of chunk number index, whose top edge is at top
+    void      generate(GLuint64 index, GLfloat top);
+};
+
+#endif
\ No newline at end of file
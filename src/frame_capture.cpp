@@ -0,0 +1,172 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "frame_capture.hpp"
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "gl_state.hpp"
+#include "image_writer.hpp"
+
+
+FrameCapture::FrameCapture(const std::string &path, GLuint width, GLuint height, GLuint frameRate)
+    : Width(width), Height(height), Frames(0), pending(0), path(path), finished(GL_FALSE)
+{
+    // Allocate the ring of pixel buffers (RGBA keeps readback on the driver's fast path)
+    for (GLuint i = 0; i < FRAME_CAPTURE_BUFFERS; ++i)
+    {
+        this->PBOs[i] = GenBuffer();
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, this->PBOs[i].ID);
+        glBufferData(GL_PIXEL_PACK_BUFFER, width * height * 4, nullptr, GL_STREAM_READ);
+        this->fences[i] = nullptr;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    // Open the output
+    this->y4m = path.size() >= 4 && path.compare(path.size() - 4, 4, ".y4m") == 0;
+    if (this->y4m)
+    {
+        this->stream.open(path.c_str(), std::ios::out | std::ios::binary);
+        if (!this->stream)
+            std::cout << "ERROR::FRAMECAPTURE: Failed to open " << path << std::endl;
+        // Full range 4:4:4, so pixels convert to YUV without any subsampling
+        this->stream << "YUV4MPEG2 W" << width << " H" << height << " F" << frameRate << ":1 Ip A1:1 C444 XCOLORRANGE=FULL\n";
+    }
+    this->encoder = std::thread(&FrameCapture::encode, this);
+}
+
+FrameCapture::~FrameCapture()
+{
+    this->Finish();
+}
+
+void FrameCapture::Capture()
+{
+    GLuint slot = this->Frames % FRAME_CAPTURE_BUFFERS;
+    // The buffer about to be reused holds the frame from FRAME_CAPTURE_BUFFERS frames ago; hand that one off first
+    if (this->fences[slot])
+        this->readBack(slot);
+    // Start an asynchronous copy of the frame into the buffer
+    GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, this->PBOs[slot].ID);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, this->Width, this->Height, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    this->fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    ++this->pending;
+    ++this->Frames;
+}
+
+void FrameCapture::Finish()
+{
+    if (this->finished)
+        return;
+    // Read back the frames still in flight, oldest first
+    for (GLuint frame = this->Frames - this->pending; frame < this->Frames; ++frame)
+        this->readBack(frame % FRAME_CAPTURE_BUFFERS);
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->finished = GL_TRUE;
+    }
+    this->queued.notify_one();
+    this->encoder.join();
+    this->stream.close();
+}
+
+void FrameCapture::readBack(GLuint slot)
+{
+    // Normally signaled long ago; only waits if the GPU is several frames behind
+    glClientWaitSync(this->fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    glDeleteSync(this->fences[slot]);
+    this->fences[slot] = nullptr;
+    --this->pending;
+
+    GLsizeiptr size = this->Width * this->Height * 4;
+    std::unique_lock<std::mutex> lock(this->mutex);
+    // Apply backpressure instead of dropping frames when the encoder falls behind
+    this->dequeued.wait(lock, [this]() { return this->queue.size() < FRAME_CAPTURE_QUEUE; });
+    std::vector<unsigned char> pixels;
+    if (!this->pool.empty())
+    {
+        pixels.swap(this->pool.back());
+        this->pool.pop_back();
+    }
+    lock.unlock();
+
+    pixels.resize(size);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, this->PBOs[slot].ID);
+    void *data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    if (data)
+    {
+        std::memcpy(pixels.data(), data, size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    else
+        std::cout << "ERROR::FRAMECAPTURE: Failed to map pixel buffer" << std::endl;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    lock.lock();
+    this->queue.push_back(std::vector<unsigned char>());
+    this->queue.back().swap(pixels);
+    lock.unlock();
+    this->queued.notify_one();
+}
+
+void FrameCapture::encode()
+{
+    GLuint frame = 0;
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (true)
+    {
+        this->queued.wait(lock, [this]() { return !this->queue.empty() || this->finished; });
+        if (this->queue.empty())
+            break; // Finished and drained
+        std::vector<unsigned char> pixels;
+        pixels.swap(this->queue.front());
+        this->queue.pop_front();
+        lock.unlock();
+        this->dequeued.notify_one();
+
+        if (this->y4m)
+            this->writeY4M(pixels);
+        else
+        {
+            std::stringstream name;
+            name << this->path << std::setw(5) << std::setfill('0') << frame << ".ppm";
+            ImageWriter::WritePPM(name.str(), this->Width, this->Height, pixels.data(), 4);
+        }
+        ++frame;
+
+        lock.lock();
+        this->pool.push_back(std::vector<unsigned char>());
+        this->pool.back().swap(pixels);
+    }
+}
+
+void FrameCapture::writeY4M(const std::vector<unsigned char> &pixels)
+{
+    // Convert to BT.601 full range planes; OpenGL's rows run bottom-up, Y4M's top-down
+    GLuint plane = this->Width * this->Height;
+    std::vector<unsigned char> yuv(plane * 3);
+    for (GLuint y = 0; y < this->Height; ++y)
+    {
+        const unsigned char *src = pixels.data() + (this->Height - 1 - y) * this->Width * 4;
+        for (GLuint x = 0; x < this->Width; ++x, src += 4)
+        {
+            GLfloat r = src[0], g = src[1], b = src[2];
+            GLuint i = y * this->Width + x;
+            yuv[i]             = static_cast<unsigned char>( 0.299f    * r + 0.587f    * g + 0.114f    * b + 0.5f);
+            yuv[plane + i]     = static_cast<unsigned char>(-0.168736f * r - 0.331264f * g + 0.5f      * b + 128.0f);
+            yuv[2 * plane + i] = static_cast<unsigned char>( 0.5f      * r - 0.418688f * g - 0.081312f * b + 128.0f);
+        }
+    }
+    this->stream << "FRAME\n";
+    this->stream.write(reinterpret_cast<const char*>(yuv.data()), yuv.size());
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "gl_object.hpp"
+
+
+// Number of pixel buffers in flight; a frame is mapped this many frames after it was rendered
+const GLuint FRAME_CAPTURE_BUFFERS = 3;
+// Number of read back frames that may wait for the encoder before capturing blocks (frames are never dropped)
+const GLuint FRAME_CAPTURE_QUEUE = 8;
+
+// FrameCapture records every rendered frame without stalling the
+// pipeline: glReadPixels writes into a ring of pixel buffer objects
+// asynchronously, and each buffer is only mapped once the GPU is
+// done with it, FRAME_CAPTURE_BUFFERS frames later. The pixels are
+// handed to a background thread that encodes them either into a
+// single Y4M stream (path ending in .y4m) or into a numbered PPM
+// sequence (path used as file name prefix).
+class FrameCapture
+{
+public:
+    // State
+    GLuint Width, Height;
+    GLuint Frames; // Frames captured so far
+    // Constructor/Destructor (the destructor finishes the capture)
+    FrameCapture(const std::string &path, GLuint width, GLuint height, GLuint frameRate = 60);
+    ~FrameCapture();
+    FrameCapture(const FrameCapture &) = delete;
+    FrameCapture &operator=(const FrameCapture &) = delete;
+    // Captures the default framebuffer; call once per frame after rendering and before swapping buffers
+    void Capture();
+    // Reads back the frames still in flight and waits until all frames are encoded
+    void Finish();
+private:
+    // Readback state
+    BufferObject PBOs[FRAME_CAPTURE_BUFFERS];
+    GLsync       fences[FRAME_CAPTURE_BUFFERS];
+    GLuint       pending; // Frames read into PBOs but not yet mapped
+    // Encoder state (shared with the encoder thread)
+    std::string                             path;
+    GLboolean                               y4m;
+    std::ofstream                           stream;
+    std::thread                             encoder;
+    std::mutex                              mutex;
+    std::condition_variable                 queued, dequeued;
+    std::deque<std::vector<unsigned char>>  queue;
+    std::vector<std::vector<unsigned char>> pool; // Recycled frame storage
+    GLboolean                               finished;
+    // Maps the given PBO and queues its pixels for encoding
+    void readBack(GLuint slot);
+    // Encoder thread: writes queued frames until finished
+    void encode();
+    void writeY4M(const std::vector<unsigned char> &pixels);
+};
+
+#endif
\ No newline at end of file
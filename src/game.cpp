@@ -22,99 +22,239 @@ using namespace irrklang;
 #include "particle_generator.hpp"
 #include "post_processor.hpp"
 #include "text_renderer.hpp"
+#include "render_queue.hpp"
+#include "uniform_buffer.hpp"
+#include "stream_buffer.hpp"
+#include "static_layer.hpp"
+#include "gpu_timer.hpp"
+#include "resolution_scaler.hpp"
+#include "sound_bank.hpp"
+#include "asset_loader.hpp"
+#include "gl_state.hpp"
 
 
 // Game-related State data
 SpriteRenderer				*Renderer;
+RenderQueue					*Queue;
 GameObject					*Player;
 std::vector<BallObject *>	Balls;
 std::map<BallObject *, ParticleGenerator *>					ballParticle;
 PostProcessor				*Effects;
 ISoundEngine				*SoundEngine = createIrrKlangDevice();
+SoundBank					*Sounds;
 GLfloat						ShakeTime = 0.0f;
 TextRenderer				*Text;
 GLuint						BricksLeft;
+UniformBuffer				*PerFrame;
+StaticLayer					*StaticScene;
+ResolutionScaler			*Resolution;
+AssetLoader					*Loader;
+// Handles of the resources used every frame and on gameplay events (resolved once by Init)
+TextureHandle				BackgroundTexture, FaceTexture, PaddleTexture, ParticleTexture, WhiteTexture;
+TextureHandle				SpeedTexture, StickyTexture, PassThroughTexture, IncreaseTexture, DecreaseTexture, BigBallTexture, MultiBallTexture, ConfuseTexture, ChaosTexture;
+ShaderHandle				ParticleShader;
+SoundHandle					BrickSound, SolidSound, PaddleSound, PowerUpSound;
 
 
 void AddBall(BallObject *ball);
 std::vector<BallObject *>::iterator RemoveBall(BallObject *ball);
+// Registers a sound file with the sound engine under its path, to be played by it (the music; effects go through the SoundBank). Views into a pack or the executable aren't copied, as they outlive the engine
+void LoadSound(const GLchar *file);
 
 Game::Game(GLuint width, GLuint height) 
-    : State(GAME_MENU), Keys(), Width(width), Height(height), Level(0), Lives(3), Score(0)
+    : State(GAME_LOADING), Keys(), Width(width), Height(height), DynamicResolution(GL_TRUE), Levels(nullptr), Level(0), Endless(nullptr), EndlessMode(GL_FALSE), Scroll(0.0f), Autoplay(GL_FALSE), Time(0.0f), Lives(3), Score(0)
 { 
 
 }
 
 Game::~Game()
 {
+    this->Shutdown();
+}
+
+void Game::Shutdown()
+{
+    delete Queue;
+    Queue = nullptr;
     delete Renderer;
+    Renderer = nullptr;
     delete Player;
+    Player = nullptr;
 	for (std::vector<BallObject *>::iterator it = Balls.begin(); it != Balls.end();)
 		it = RemoveBall((*it));
     delete Effects;
+    Effects = nullptr;
     delete Text;
-    SoundEngine->drop();
+    Text = nullptr;
+    delete PerFrame;
+    PerFrame = nullptr;
+    delete StaticScene;
+    StaticScene = nullptr;
+    delete Resolution;
+    Resolution = nullptr;
+    delete Loader;
+    Loader = nullptr;
+    delete this->Endless;
+    this->Endless = nullptr;
+    delete this->Levels;
+    this->Levels = nullptr;
+    delete Sounds;
+    Sounds = nullptr;
+    if (SoundEngine != nullptr)
+        SoundEngine->drop();
+    SoundEngine = nullptr;
 }
 
 void Game::Init()
 {
-    // Load shaders
-    ResourceManager::LoadShader("shaders/sprite.vert", "shaders/sprite.frag", nullptr, "sprite");
-    ResourceManager::LoadShader("shaders/particle.vert", "shaders/particle.frag", nullptr, "particle");
-    ResourceManager::LoadShader("shaders/post_processing.vert", "shaders/post_processing.frag", nullptr, "postprocessing");
-    // Configure shaders
-    glm::mat4 projection = glm::ortho(0.0f, static_cast<GLfloat>(this->Width), static_cast<GLfloat>(this->Height), 0.0f, -1.0f, 1.0f);
-    ResourceManager::GetShader("sprite").Use().SetInteger("sprite", 0);
-    ResourceManager::GetShader("sprite").SetMatrix4("projection", projection);
-    ResourceManager::GetShader("particle").Use().SetInteger("sprite", 0);
-    ResourceManager::GetShader("particle").SetMatrix4("projection", projection);
-    // Load textures
-    ResourceManager::LoadTexture("assets/textures/background.jpg", GL_FALSE, "background");
-    ResourceManager::LoadTexture("assets/textures/awesomeface.png", GL_TRUE, "face");
-    ResourceManager::LoadTexture("assets/textures/block.png", GL_FALSE, "block");
-    ResourceManager::LoadTexture("assets/textures/block_solid.png", GL_FALSE, "block_solid");
-    ResourceManager::LoadTexture("assets/textures/paddle.png", GL_TRUE, "paddle");
-    ResourceManager::LoadTexture("assets/textures/particle.png", GL_TRUE, "particle");
-    ResourceManager::LoadTexture("assets/textures/powerup_speed.png", GL_TRUE, "powerup_speed");
-    ResourceManager::LoadTexture("assets/textures/powerup_sticky.png", GL_TRUE, "powerup_sticky");
-    ResourceManager::LoadTexture("assets/textures/powerup_increase.png", GL_TRUE, "powerup_increase");
-    ResourceManager::LoadTexture("assets/textures/powerup_confuse.png", GL_TRUE, "powerup_confuse");
-    ResourceManager::LoadTexture("assets/textures/powerup_chaos.png", GL_TRUE, "powerup_chaos");
-    ResourceManager::LoadTexture("assets/textures/powerup_passthrough.png", GL_TRUE, "powerup_passthrough");
-	ResourceManager::LoadTexture("assets/textures/powerup_decrease.png", GL_TRUE, "powerup_decrease");
-	ResourceManager::LoadTexture("assets/textures/powerup_bigball.png", GL_TRUE, "powerup_bigball");
-	ResourceManager::LoadTexture("assets/textures/powerup_multiball.png", GL_TRUE, "powerup_multiball");
+    // Serve assets from the pack when there is one (otherwise from the executable and the loose files)
+    ResourceManager::MountPack(ASSET_PACK_FILE);
+    // Load shaders (queued, so the driver compiles them while the assets below load)
+    ResourceManager::QueueShader("shaders/sprite.vert", "shaders/sprite.frag", nullptr, "sprite");
+    ResourceManager::QueueShader("shaders/particle.vert", "shaders/particle.frag", nullptr, "particle");
+    ResourceManager::QueueShader("shaders/blit.vert", "shaders/blit.frag", nullptr, "blit");
+    // Load textures (decoded on the loader's worker threads, uploaded by Update as they arrive)
+    Loader = new AssetLoader();
+    Loader->QueueTexture("assets/textures/background.jpg", GL_FALSE, "background");
+    Loader->QueueTexture("assets/textures/awesomeface.png", GL_TRUE, "face");
+    Loader->QueueTexture("assets/textures/block.png", GL_FALSE, "block");
+    Loader->QueueTexture("assets/textures/block_solid.png", GL_FALSE, "block_solid");
+    Loader->QueueTexture("assets/textures/paddle.png", GL_TRUE, "paddle");
+    Loader->QueueTexture("assets/textures/particle.png", GL_TRUE, "particle");
+    Loader->QueueTexture("assets/textures/powerup_speed.png", GL_TRUE, "powerup_speed");
+    Loader->QueueTexture("assets/textures/powerup_sticky.png", GL_TRUE, "powerup_sticky");
+    Loader->QueueTexture("assets/textures/powerup_increase.png", GL_TRUE, "powerup_increase");
+    Loader->QueueTexture("assets/textures/powerup_confuse.png", GL_TRUE, "powerup_confuse");
+    Loader->QueueTexture("assets/textures/powerup_chaos.png", GL_TRUE, "powerup_chaos");
+    Loader->QueueTexture("assets/textures/powerup_passthrough.png", GL_TRUE, "powerup_passthrough");
+	Loader->QueueTexture("assets/textures/powerup_decrease.png", GL_TRUE, "powerup_decrease");
+	Loader->QueueTexture("assets/textures/powerup_bigball.png", GL_TRUE, "powerup_bigball");
+	Loader->QueueTexture("assets/textures/powerup_multiball.png", GL_TRUE, "powerup_multiball");
+    // Resolve the handles of the textures used during play (they fill in as the loader uploads them)
+    BackgroundTexture = ResourceManager::FindTexture("background");
+    FaceTexture = ResourceManager::FindTexture("face");
+    PaddleTexture = ResourceManager::FindTexture("paddle");
+    ParticleTexture = ResourceManager::FindTexture("particle");
+    WhiteTexture = ResourceManager::FindTexture("white");
+    SpeedTexture = ResourceManager::FindTexture("powerup_speed");
+    StickyTexture = ResourceManager::FindTexture("powerup_sticky");
+    PassThroughTexture = ResourceManager::FindTexture("powerup_passthrough");
+    IncreaseTexture = ResourceManager::FindTexture("powerup_increase");
+    DecreaseTexture = ResourceManager::FindTexture("powerup_decrease");
+    BigBallTexture = ResourceManager::FindTexture("powerup_bigball");
+    MultiBallTexture = ResourceManager::FindTexture("powerup_multiball");
+    ConfuseTexture = ResourceManager::FindTexture("powerup_confuse");
+    ChaosTexture = ResourceManager::FindTexture("powerup_chaos");
+    ParticleShader = ResourceManager::FindShader("particle");
+    // List the levels (each is loaded when it or a neighbour is selected)
+    this->Levels = new LevelCatalogue(LEVEL_DIRECTORY, this->Width, this->Height * 0.5);
+    // Load font
+    Text = new TextRenderer();
+    Loader->QueueFont(*Text, "assets/fonts/ocraext.ttf", 24);
+    // Plain white texture the loading screen draws its progress bar with
+    DecodedImage white;
+    white.Width = white.Height = 1;
+    white.Alpha = GL_TRUE;
+    white.Pixels.assign(4, 255);
+    ResourceManager::LoadTexture(white, "white");
+    // Configure shaders (projection and time are shared through the per-frame uniform block)
+    ResourceManager::GetShader("sprite").Use().SetInteger("image", 0);
+    ResourceManager::GetShader(ParticleShader).Use().SetInteger("sprite", 0);
+    PerFrame = new UniformBuffer(FRAME_UNIFORM_BINDING, sizeof(FrameUniforms));
     // Set render-specific controls
     Renderer = new SpriteRenderer(ResourceManager::GetShader("sprite"));
-    Effects = new PostProcessor(ResourceManager::GetShader("postprocessing"), this->Width, this->Height);
-    Text = new TextRenderer(this->Width, this->Height);
-    Text->Load("assets/fonts/ocraext.ttf", 24);
-    // Load levels
-    GameLevel one; one.Load("assets/levels/one.lvl", this->Width, this->Height * 0.5);
-    GameLevel two; two.Load("assets/levels/two.lvl", this->Width, this->Height * 0.5);
-    GameLevel three; three.Load("assets/levels/three.lvl", this->Width, this->Height * 0.5);
-    GameLevel four; four.Load("assets/levels/four.lvl", this->Width, this->Height * 0.5);
-    this->Levels.push_back(one);
-    this->Levels.push_back(two);
-    this->Levels.push_back(three);
-    this->Levels.push_back(four);
+    Queue = new RenderQueue(*Renderer, ResourceManager::GetShader("sprite"));
+    Effects = new PostProcessor(this->Width, this->Height, SCENE_SAMPLES);
+    StaticScene = new StaticLayer(ResourceManager::GetShader("blit"), this->Width, this->Height);
+    Resolution = new ResolutionScaler(GPU_FRAME_BUDGET);
+    this->State = GAME_LOADING;
+}
+
+void Game::FinishLoading()
+{
+    Loader->Update(0.0f);
+    delete Loader;
+    Loader = nullptr;
+    // The game objects keep views of these textures, so they must stay resident whatever the texture budget (for the whole session)
+    TextureHandle held[] = { BackgroundTexture, FaceTexture, PaddleTexture, ParticleTexture, SpeedTexture, StickyTexture, PassThroughTexture,
+                             IncreaseTexture, DecreaseTexture, BigBallTexture, MultiBallTexture, ConfuseTexture, ChaosTexture };
+    for (TextureHandle handle : held)
+        ResourceManager::AcquireTexture(handle);
+    // Load the first level now that the block textures are uploaded, and its neighbours in the background
     this->Level = 0;
-	BricksLeft = this->Levels[this->Level].CountBlocks(GL_FALSE);
+	BricksLeft = this->Levels->Get(this->Level).CountBlocks(GL_FALSE);
+    this->Levels->Prefetch(this->Level);
+    // The endless playfield's chunk slots are allocated once, here, and recycled for every endless game
+    this->Endless = new EndlessLevel(this->Width, ENDLESS_ROW_HEIGHT, this->Height, ResourceManager::GetTexture("block_solid"), ResourceManager::GetTexture("block"));
     // Configure game objects
     glm::vec2 playerPos = glm::vec2(this->Width / 2 - PLAYER_SIZE.x / 2, this->Height - PLAYER_SIZE.y);
-    Player = new GameObject(playerPos, PLAYER_SIZE, ResourceManager::GetTexture("paddle"));
+    Player = new GameObject(playerPos, PLAYER_SIZE, ResourceManager::GetTexture(PaddleTexture));
     glm::vec2 ballPos = playerPos + glm::vec2(PLAYER_SIZE.x / 2 - BALL_RADIUS, -BALL_RADIUS * 2);
-	BallObject *ball = new BallObject(ballPos, BALL_RADIUS, INITIAL_BALL_VELOCITY, ResourceManager::GetTexture("face"));
+	BallObject *ball = new BallObject(ballPos, BALL_RADIUS, INITIAL_BALL_VELOCITY, ResourceManager::GetTexture(FaceTexture));
 	AddBall(ball);
-    // Audio
-    SoundEngine->play2D("assets/audio/breakout.mp3", GL_TRUE);
+    // Audio (the music streams; the effects are played through the bank, ranked by how much they tell the player)
+    LoadSound("assets/audio/breakout.mp3");
+    Sounds = new SoundBank(SoundEngine);
+    BrickSound = Sounds->Load("assets/audio/bleep.mp3", 0);
+    SolidSound = Sounds->Load("assets/audio/solid.wav", 0);
+    PaddleSound = Sounds->Load("assets/audio/bleep.wav", 1);
+    PowerUpSound = Sounds->Load("assets/audio/powerup.wav", 2);
+    if (SoundEngine != nullptr)
+        SoundEngine->play2D("assets/audio/breakout.mp3", GL_TRUE);
+    this->State = GAME_MENU;
+}
+
+void Game::StartEndless()
+{
+    this->EndlessMode = GL_TRUE;
+    this->ResetLevel();
+    this->ResetPlayer();
+    this->Score = 0;
+    this->State = GAME_ACTIVE;
+}
+
+void Game::Resize(GLuint width, GLuint height)
+{
+    if (width == 0 || height == 0)
+        return; // Minimized
+    // Fit the canvas into the window preserving its aspect ratio; the remaining bars stay black
+    GLfloat scale = std::min(static_cast<GLfloat>(width) / this->Width, static_cast<GLfloat>(height) / this->Height);
+    GLuint viewportWidth = std::max(1, static_cast<GLint>(this->Width * scale));
+    GLuint viewportHeight = std::max(1, static_cast<GLint>(this->Height * scale));
+    Effects->Resize((width - viewportWidth) / 2, (height - viewportHeight) / 2, viewportWidth, viewportHeight);
+    StaticScene->Resize(viewportWidth, viewportHeight);
 }
 
 void Game::Update(GLfloat dt)
 {
+    this->Time += dt;
+    // Upload what the loader decoded since the last frame (the game itself starts once everything is loaded)
+    if (this->State == GAME_LOADING)
+    {
+        if (Loader->Update(LOADING_FRAME_BUDGET))
+            this->FinishLoading();
+        return;
+    }
+    Sounds->Update(dt);
+    // While the player picks a level, load the ones around the selection in the background
+    if (this->State == GAME_MENU || this->State == GAME_WIN)
+        this->Levels->Prefetch(this->Level);
+    // Scroll the view up the endless playfield; the paddle (and the balls resting on it) move along with it
+    if (this->State == GAME_ACTIVE && this->EndlessMode)
+    {
+        GLfloat distance = ENDLESS_SCROLL_SPEED * dt;
+        this->Scroll -= distance;
+        Player->Position.y -= distance;
+		for (BallObject *Ball : Balls)
+			if (Ball->Stuck)
+				Ball->Position.y -= distance;
+        if (this->Scroll < -ENDLESS_REBASE_DISTANCE)
+            this->ShiftWorld(ENDLESS_REBASE_DISTANCE);
+        this->Endless->Update(this->Scroll);
+    }
     // Update objects
 	for (BallObject *Ball : Balls)
-		Ball->Move(dt, this->Width);
+		Ball->Move(dt, this->Width, this->Scroll);
     // Check for collisions
     this->DoCollisions();
     // Update particles	
@@ -135,7 +275,7 @@ void Game::Update(GLfloat dt)
 
 	for (std::vector<BallObject *>::iterator it = Balls.begin(); it != Balls.end();)
 	{
-		if ((*it)->Position.y >= this->Height)
+		if ((*it)->Position.y >= this->Scroll + this->Height)
 		{
 			it = RemoveBall((*it));
 		}
@@ -150,14 +290,15 @@ void Game::Update(GLfloat dt)
 		// Did the player lose all his lives? : Game over
 		if (this->Lives == 0)
 		{
+			this->EndlessMode = GL_FALSE;
 			this->ResetLevel();
 			this->State = GAME_MENU;
 		}
 		this->ResetPlayer();
 	}
 
-    // Check win condition
-    if (this->State == GAME_ACTIVE && this->Levels[this->Level].IsCompleted())
+    // Check win condition (the endless mode has none)
+    if (this->State == GAME_ACTIVE && !this->EndlessMode && this->Levels->Get(this->Level).IsCompleted())
     {
         this->ResetLevel();
         this->ResetPlayer();
@@ -177,10 +318,16 @@ void Game::ProcessInput(GLfloat dt)
 			this->Score = 0;
             this->KeysProcessed[GLFW_KEY_ENTER] = GL_TRUE;
         }
+        if (this->Keys[GLFW_KEY_E] && !this->KeysProcessed[GLFW_KEY_E])
+        {
+            this->StartEndless();
+            this->KeysProcessed[GLFW_KEY_E] = GL_TRUE;
+        }
         if (this->Keys[GLFW_KEY_W] && !this->KeysProcessed[GLFW_KEY_W])
         {
-            this->Level = (this->Level + 1) % 4;
-			BricksLeft = this->Levels[this->Level].CountBlocks(GL_FALSE);
+            this->Level = (this->Level + 1) % this->Levels->Count();
+			BricksLeft = this->Levels->Get(this->Level).CountBlocks(GL_FALSE);
+            StaticScene->Invalidate();
             this->KeysProcessed[GLFW_KEY_W] = GL_TRUE;
         }
         if (this->Keys[GLFW_KEY_S] && !this->KeysProcessed[GLFW_KEY_S])
@@ -188,8 +335,9 @@ void Game::ProcessInput(GLfloat dt)
             if (this->Level > 0)
                 --this->Level;
             else
-                this->Level = 3;
-			BricksLeft = this->Levels[this->Level].CountBlocks(GL_FALSE);
+                this->Level = this->Levels->Count() - 1;
+			BricksLeft = this->Levels->Get(this->Level).CountBlocks(GL_FALSE);
+            StaticScene->Invalidate();
             this->KeysProcessed[GLFW_KEY_S] = GL_TRUE;
         }
     }
@@ -205,6 +353,18 @@ void Game::ProcessInput(GLfloat dt)
     if (this->State == GAME_ACTIVE)
     {
         GLfloat velocity = PLAYER_VELOCITY * dt;
+        // Steer towards the lowest ball (the one closest to being lost) and keep launching balls
+        if (this->Autoplay)
+        {
+            BallObject *lowest = nullptr;
+			for (BallObject *Ball : Balls)
+				if (!lowest || Ball->Position.y > lowest->Position.y)
+					lowest = Ball;
+            GLfloat target = lowest ? lowest->Position.x + lowest->Radius - Player->Size.x / 2 : Player->Position.x;
+            this->Keys[GLFW_KEY_A] = target < Player->Position.x - velocity;
+            this->Keys[GLFW_KEY_D] = target > Player->Position.x + velocity;
+            this->Keys[GLFW_KEY_SPACE] = GL_TRUE;
+        }
         // Move playerboard
         if (this->Keys[GLFW_KEY_A])
         {
@@ -234,77 +394,116 @@ void Game::ProcessInput(GLfloat dt)
 
 void Game::Render()
 {
+    GpuTimer::Begin("frame");
+    // Upload the data shared by all draw calls of this frame
+    FrameUniforms frame = FrameUniforms();
+    frame.Projection = glm::ortho(0.0f, static_cast<GLfloat>(this->Width), static_cast<GLfloat>(this->Height), 0.0f, -1.0f, 1.0f);
+    frame.View = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -this->Scroll, 0.0f));
+    frame.Time = this->Time;
+    PerFrame->Update(&frame);
+    if (this->State == GAME_LOADING)
+    {
+        // Progress bar on a black screen (no text: the font is one of the assets being loaded)
+        GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glViewport(Effects->Viewport.x, Effects->Viewport.y, Effects->Viewport.z, Effects->Viewport.w);
+        TextureView white = ResourceManager::GetTexture(WhiteTexture);
+        glm::vec2 position = (glm::vec2(this->Width, this->Height) - LOADING_BAR_SIZE) * 0.5f;
+        glm::vec2 progress(LOADING_BAR_SIZE.x * Loader->Progress(), LOADING_BAR_SIZE.y);
+        Renderer->DrawSprite(white, position, LOADING_BAR_SIZE, 0.0f, glm::vec3(0.2f));
+        Renderer->DrawSprite(white, position, progress, 0.0f, glm::vec3(1.0f));
+    }
     if (this->State == GAME_ACTIVE || this->State == GAME_MENU || this->State == GAME_WIN)
     {
-        // Begin rendering to postprocessing quad
+        // Bring the cached background and level up to date (only regions where bricks changed are redrawn);
+        // the endless playfield moves every frame, so it is queued with the dynamic objects instead
+        GpuTimer::Begin("static");
+        if (this->EndlessMode)
+        {
+            Queue->SubmitSprite(LAYER_BACKGROUND, ResourceManager::GetTexture(BackgroundTexture), glm::vec2(0.0f, this->Scroll), glm::vec2(this->Width, this->Height));
+            this->Endless->Draw(*Queue);
+        }
+        else
+            StaticScene->Update(*Queue, ResourceManager::GetTexture(BackgroundTexture), this->Levels->Get(this->Level));
+        GpuTimer::End("static");
+        // Queue the dynamic objects; draw order is determined by each command's layer
+        Player->Draw(*Queue, LAYER_PLAYER);
+        for (PowerUp &powerUp : this->PowerUps)
+            if (!powerUp.Destroyed)
+                powerUp.Draw(*Queue, LAYER_POWERUPS);
+		for (BallObject *Ball : Balls)
+			if (!Ball->Stuck)
+				ballParticle[Ball]->Draw(*Queue);
+		for (BallObject *Ball : Balls)
+			Ball->Draw(*Queue, LAYER_BALLS);
+        // Pick the render scale from recent GPU timings, then begin rendering to postprocessing quad
+        Effects->Scale = this->DynamicResolution ? Resolution->Update(GpuTimer::Milliseconds("frame")) : 1.0f;
+        GpuTimer::Begin("scene");
         Effects->BeginRender();
-            // Draw background
-            Renderer->DrawSprite(ResourceManager::GetTexture("background"), glm::vec2(0, 0), glm::vec2(this->Width, this->Height), 0.0f);
-            // Draw level
-            this->Levels[this->Level].Draw(*Renderer);
-            // Draw player
-            Player->Draw(*Renderer);
-            // Draw PowerUps
-            for (PowerUp &powerUp : this->PowerUps)
-                if (!powerUp.Destroyed)
-                    powerUp.Draw(*Renderer);
-            // Draw particles	
-			for (BallObject *Ball : Balls)
-				if (!Ball->Stuck)
-					ballParticle[Ball]->Draw();
-            // Draw ball
-			for (BallObject *Ball : Balls)
-				Ball->Draw(*Renderer);            
+            if (!this->EndlessMode)
+                StaticScene->Draw();
+            Queue->Flush();
+        GpuTimer::End("scene");
         // End rendering to postprocessing quad
         Effects->EndRender();
         // Render postprocessing quad
-        Effects->Render(glfwGetTime());
+        Effects->Render();
         // Render text (don't include in postprocessing)
+        GpuTimer::Begin("text");
         std::stringstream sLives; sLives << this->Lives;
 		std::stringstream sScore; sScore << this->Score;
 		std::stringstream sBricks; sBricks << BricksLeft;
         Text->RenderText("Lives:" + sLives.str(), 5.0f, 5.0f, 1.0f);
 		Text->RenderText("Score:" + sScore.str(), this->Width/2 - 50, 5.0f, 1.0f);
-		Text->RenderText("Bricks left:" + sBricks.str(), this->Width - 230, 5.0f, 1.0f);
-    }
-    if (this->State == GAME_MENU)
-    {
-        Text->RenderText("Press ENTER to start", 250.0f, this->Height / 2, 1.0f);
-        Text->RenderText("Press W or S to select level", 245.0f, this->Height / 2 + 20.0f, 0.75f);
-    }
-    if (this->State == GAME_WIN)
-    {
-        Text->RenderText("You WON!!!", 320.0f, this->Height / 2 - 20.0f, 1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
-        Text->RenderText("Press ENTER to retry or ESC to quit", 130.0f, this->Height / 2, 1.0f, glm::vec3(1.0f, 1.0f, 0.0f));
+		if (!this->EndlessMode)
+			Text->RenderText("Bricks left:" + sBricks.str(), this->Width - 230, 5.0f, 1.0f);
+        // The menu and win screens are drawn over the level, within the same pass
+        if (this->State == GAME_MENU)
+        {
+            Text->RenderText("Press ENTER to start", 250.0f, this->Height / 2, 1.0f);
+            Text->RenderText("Press W or S to select level", 245.0f, this->Height / 2 + 20.0f, 0.75f);
+            Text->RenderText("Press E for endless mode", 275.0f, this->Height / 2 + 40.0f, 0.75f);
+        }
+        if (this->State == GAME_WIN)
+        {
+            Text->RenderText("You WON!!!", 320.0f, this->Height / 2 - 20.0f, 1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+            Text->RenderText("Press ENTER to retry or ESC to quit", 130.0f, this->Height / 2, 1.0f, glm::vec3(1.0f, 1.0f, 0.0f));
+        }
+        GpuTimer::End("text");
     }
+    GpuTimer::End("frame");
+    GpuTimer::EndFrame();
+    // Fence this frame's streamed vertex data
+    StreamBuffer::EndFrame();
 }
 
 
 void Game::ResetLevel()
 {
-    if (this->Level == 0)this->Levels[0].Load("assets/levels/one.lvl", this->Width, this->Height * 0.5f);
-    else if (this->Level == 1)
-        this->Levels[1].Load("assets/levels/two.lvl", this->Width, this->Height * 0.5f);
-    else if (this->Level == 2)
-        this->Levels[2].Load("assets/levels/three.lvl", this->Width, this->Height * 0.5f);
-    else if (this->Level == 3)
-        this->Levels[3].Load("assets/levels/four.lvl", this->Width, this->Height * 0.5f);
+    // Restore the bricks from the level's template rather than loading it again
+    this->Levels->Get(this->Level).Reset();
+    // The endless playfield starts over with its bricks above the middle of the view
+    this->Scroll = 0.0f;
+    if (this->EndlessMode)
+        this->Endless->Reset(this->Height * 0.5f);
 
     this->Lives = 3;
-	BricksLeft = this->Levels[this->Level].CountBlocks(GL_FALSE);
+	BricksLeft = this->Levels->Get(this->Level).CountBlocks(GL_FALSE);
+    StaticScene->Invalidate();
 }
 
 void Game::ResetPlayer()
 {
     // Reset player/ball stats
     Player->Size = PLAYER_SIZE;
-    Player->Position = glm::vec2(this->Width / 2 - PLAYER_SIZE.x / 2, this->Height - PLAYER_SIZE.y);
+    Player->Position = glm::vec2(this->Width / 2 - PLAYER_SIZE.x / 2, this->Scroll + this->Height - PLAYER_SIZE.y);
 
 	glm::vec2 ballPos = Player->Position + glm::vec2(PLAYER_SIZE.x / 2 - BALL_RADIUS, -BALL_RADIUS * 2);
 	for (std::vector<BallObject *>::iterator it = Balls.begin(); it != Balls.end();)
 		it = RemoveBall((*it));
 
-	BallObject *newball = new BallObject(ballPos, BALL_RADIUS, INITIAL_BALL_VELOCITY, ResourceManager::GetTexture("face"));
+	BallObject *newball = new BallObject(ballPos, BALL_RADIUS, INITIAL_BALL_VELOCITY, ResourceManager::GetTexture(FaceTexture));
 	AddBall(newball);
 
     Effects->Chaos = Effects->Confuse = GL_FALSE;
@@ -421,23 +620,23 @@ glm::vec2 PowerUpVelocity() {
 void Game::SpawnPowerUps(GameObject &block)
 {
     if (ShouldSpawn(75)) // 1 in 75 chance
-        this->PowerUps.push_back(PowerUp("speed", glm::vec3(0.5f, 0.5f, 1.0f), 0.0f, block.Position, ResourceManager::GetTexture("powerup_speed"), VELOCITY * 1.5f));
+        this->PowerUps.push_back(PowerUp("speed", glm::vec3(0.5f, 0.5f, 1.0f), 0.0f, block.Position, ResourceManager::GetTexture(SpeedTexture), VELOCITY * 1.5f));
     if (ShouldSpawn(75))
-        this->PowerUps.push_back(PowerUp("sticky", glm::vec3(1.0f, 0.5f, 1.0f), 20.0f, block.Position, ResourceManager::GetTexture("powerup_sticky"), VELOCITY * 1.5f));
+        this->PowerUps.push_back(PowerUp("sticky", glm::vec3(1.0f, 0.5f, 1.0f), 20.0f, block.Position, ResourceManager::GetTexture(StickyTexture), VELOCITY * 1.5f));
     if (ShouldSpawn(75))
-        this->PowerUps.push_back(PowerUp("pass-through", glm::vec3(0.5f, 1.0f, 0.5f), 10.0f, block.Position, ResourceManager::GetTexture("powerup_passthrough"), VELOCITY * 1.5f));
+        this->PowerUps.push_back(PowerUp("pass-through", glm::vec3(0.5f, 1.0f, 0.5f), 10.0f, block.Position, ResourceManager::GetTexture(PassThroughTexture), VELOCITY * 1.5f));
     if (ShouldSpawn(75))
-        this->PowerUps.push_back(PowerUp("pad-size-increase", glm::vec3(1.0f, 0.6f, 0.4f), 10.0f, block.Position, ResourceManager::GetTexture("powerup_increase"), VELOCITY * 1.5f));
+        this->PowerUps.push_back(PowerUp("pad-size-increase", glm::vec3(1.0f, 0.6f, 0.4f), 10.0f, block.Position, ResourceManager::GetTexture(IncreaseTexture), VELOCITY * 1.5f));
 	if (ShouldSpawn(75))
-		this->PowerUps.push_back(PowerUp("ball-big", glm::vec3(0.15f, 0.55f, 0.15f), 10.0f, block.Position, ResourceManager::GetTexture("powerup_bigball"), VELOCITY * 1.5f));
+		this->PowerUps.push_back(PowerUp("ball-big", glm::vec3(0.15f, 0.55f, 0.15f), 10.0f, block.Position, ResourceManager::GetTexture(BigBallTexture), VELOCITY * 1.5f));
 	if (ShouldSpawn(2))
-		this->PowerUps.push_back(PowerUp("ball-multi", glm::vec3(0.15f, 0.55f, 0.15f), 0.0f, block.Position, ResourceManager::GetTexture("powerup_multiball"), VELOCITY * 1.5f));
+		this->PowerUps.push_back(PowerUp("ball-multi", glm::vec3(0.15f, 0.55f, 0.15f), 0.0f, block.Position, ResourceManager::GetTexture(MultiBallTexture), VELOCITY * 1.5f));
 	if (ShouldSpawn(15))
-		this->PowerUps.push_back(PowerUp("pad-size-decrease", glm::vec3(0.8f, 0.6f, 0.2f), 20.0f, block.Position, ResourceManager::GetTexture("powerup_decrease")));
+		this->PowerUps.push_back(PowerUp("pad-size-decrease", glm::vec3(0.8f, 0.6f, 0.2f), 20.0f, block.Position, ResourceManager::GetTexture(DecreaseTexture)));
     if (ShouldSpawn(15)) // Negative powerups should spawn more often
-        this->PowerUps.push_back(PowerUp("confuse", glm::vec3(1.0f, 0.3f, 0.3f), 15.0f, block.Position, ResourceManager::GetTexture("powerup_confuse")));
+        this->PowerUps.push_back(PowerUp("confuse", glm::vec3(1.0f, 0.3f, 0.3f), 15.0f, block.Position, ResourceManager::GetTexture(ConfuseTexture)));
     if (ShouldSpawn(15))
-        this->PowerUps.push_back(PowerUp("chaos", glm::vec3(0.9f, 0.25f, 0.25f), 15.0f, block.Position, ResourceManager::GetTexture("powerup_chaos")));
+        this->PowerUps.push_back(PowerUp("chaos", glm::vec3(0.9f, 0.25f, 0.25f), 15.0f, block.Position, ResourceManager::GetTexture(ChaosTexture)));
 }
 
 void ActivatePowerUp(PowerUp &powerUp)
@@ -478,7 +677,7 @@ void ActivatePowerUp(PowerUp &powerUp)
 		newball->Position = Player->Position + glm::vec2(PLAYER_SIZE.x / 2 - BALL_RADIUS, -BALL_RADIUS * 2);
 		newball->Velocity = glm::vec2(-newball->Velocity.x, -glm::abs(newball->Velocity.y));
 		Balls.push_back(newball);
-		ballParticle[newball] = new ParticleGenerator(ResourceManager::GetShader("particle"), ResourceManager::GetTexture("particle"), PARTICLE_AMOUNT);
+		ballParticle[newball] = new ParticleGenerator(ResourceManager::GetShader(ParticleShader), ResourceManager::GetTexture(ParticleTexture), PARTICLE_AMOUNT);
 	}
 	else if (powerUp.Type == "pad-size-decrease")
 	{
@@ -520,7 +719,8 @@ Direction VectorDirection(glm::vec2 closest);
 
 void Game::DoCollisions()
 {
-    for (GameObject &box : this->Levels[this->Level].Bricks)
+    std::vector<GameObject> &bricks = this->EndlessMode ? this->Endless->Bricks : this->Levels->Get(this->Level).Bricks;
+    for (GameObject &box : bricks)
     {
         if (!box.Destroyed)
         {
@@ -533,16 +733,20 @@ void Game::DoCollisions()
 					if (!box.IsSolid)
 					{
 						box.Destroyed = GL_TRUE;
+						if (!this->EndlessMode)
+						{
+							StaticScene->MarkDirty(box.Position, box.Size);
+							BricksLeft--;
+						}
 						this->SpawnPowerUps(box);
-						SoundEngine->play2D("assets/audio/bleep.mp3", GL_FALSE);
-						BricksLeft--;
+						Sounds->Play(BrickSound);
 						this->Score += 3;
 					}
 					else
 					{   // if block is solid, enable shake effect
 						ShakeTime = 0.05f;
 						Effects->Shake = GL_TRUE;
-						SoundEngine->play2D("assets/audio/solid.wav", GL_FALSE);
+						Sounds->Play(SolidSound);
 					}
 					// Collision resolution
 					Direction dir = std::get<1>(collision);
@@ -581,7 +785,7 @@ void Game::DoCollisions()
         if (!powerUp.Destroyed)
         {
             // First check if powerup passed bottom edge, if so: keep as inactive and destroy
-            if (powerUp.Position.y >= this->Height)
+            if (powerUp.Position.y >= this->Scroll + this->Height)
                 powerUp.Destroyed = GL_TRUE;
 
             if (CheckCollision(*Player, powerUp))
@@ -589,7 +793,7 @@ void Game::DoCollisions()
                 ActivatePowerUp(powerUp);
                 powerUp.Destroyed = GL_TRUE;
                 powerUp.Activated = GL_TRUE;
-                SoundEngine->play2D("assets/audio/powerup.wav", GL_FALSE);
+                Sounds->Play(PowerUpSound);
             }
         }
     }
@@ -616,11 +820,26 @@ void Game::DoCollisions()
 			// If Sticky powerup is activated, also stick ball to paddle once new velocity vectors were calculated
 			Ball->Stuck = Ball->Sticky;
 
-			SoundEngine->play2D("assets/audio/bleep.wav", GL_FALSE);
+			Sounds->Play(PaddleSound);
 		}
 	}
 }
 
+void Game::ShiftWorld(GLfloat offset)
+{
+    glm::vec2 shift(0.0f, offset);
+    this->Scroll += offset;
+    Player->Position += shift;
+	for (BallObject *Ball : Balls)
+	{
+		Ball->Position += shift;
+		ballParticle[Ball]->Shift(shift);
+	}
+    for (PowerUp &powerUp : this->PowerUps)
+        powerUp.Position += shift;
+    this->Endless->Shift(offset);
+}
+
 GLboolean CheckCollision(GameObject &one, GameObject &two) // AABB - AABB collision
 {
     // Collision x-axis?
@@ -681,7 +900,7 @@ void AddBall(BallObject *ball)
 {
 	Balls.push_back(ball);
 	if (ballParticle.find(ball) == ballParticle.end())
-		ballParticle[ball] = new ParticleGenerator(ResourceManager::GetShader("particle"), ResourceManager::GetTexture("particle"), PARTICLE_AMOUNT);
+		ballParticle[ball] = new ParticleGenerator(ResourceManager::GetShader(ParticleShader), ResourceManager::GetTexture(ParticleTexture), PARTICLE_AMOUNT);
 	else
 		ballParticle[ball]->Reset();
 }
@@ -700,4 +919,12 @@ std::vector<BallObject *>::iterator RemoveBall(BallObject *ball)
 		return Balls.erase(it);
 	else
 		throw;
+}
+
+void LoadSound(const GLchar *file)
+{
+    // Without an audio device there is no engine, and the game runs silently
+    AssetView sound;
+    if (SoundEngine != nullptr && ResourceManager::ReadAsset(file, sound))
+        SoundEngine->addSoundSourceFromMemory(const_cast<unsigned char*>(sound.Data), static_cast<ik_s32>(sound.Size), file, !sound.Storage.empty() || sound.Mapping);
 }
\ No newline at end of file
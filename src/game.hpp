@@ -14,10 +14,13 @@
 #include <GLFW/glfw3.h>
 
 #include "game_level.hpp"
+#include "level_catalogue.hpp"
+#include "endless_level.hpp"
 #include "powerup.hpp"
 
 // Represents the current state of the game
 enum GameState {
+    GAME_LOADING,
     GAME_ACTIVE,
     GAME_MENU,
     GAME_WIN
@@ -43,6 +46,14 @@ const glm::vec2 INITIAL_BALL_VELOCITY(100.0f, -350.0f);
 const GLfloat BALL_RADIUS = 12.5f;
 // Amount of ball particles
 const GLuint PARTICLE_AMOUNT = 500;
+// Number of samples of the offscreen target used for postprocessing effects
+const GLuint SCENE_SAMPLES = 8;
+// GPU time per frame (in milliseconds) dynamic resolution scaling tries to stay within
+const GLfloat GPU_FRAME_BUDGET = 12.0f;
+// Time per frame (in seconds) the loading screen spends uploading loaded assets
+const GLfloat LOADING_FRAME_BUDGET = 0.008f;
+// Size of the loading screen's progress bar
+const glm::vec2 LOADING_BAR_SIZE(400.0f, 20.0f);
 
 // Game holds all game-related state and functionality.
 // Combines all game-related data into a single class for
@@ -56,22 +67,36 @@ public:
     GameState              State;	
     GLboolean              Keys[1024];
 	GLboolean			   KeysProcessed[1024];
-    GLuint                 Width, Height;
-    std::vector<GameLevel> Levels;
-    GLuint                 Level;
+    GLuint                 Width, Height; // Size of the virtual canvas the game is laid out on
+    GLboolean              DynamicResolution; // Whether the render scale adapts to GPU frame time
+    LevelCatalogue        *Levels; // Loaded on demand
+    GLuint                 Level;  // Index of the selected level in the catalogue
+    EndlessLevel          *Endless; // Playfield of the endless mode
+    GLboolean              EndlessMode; // Whether the endless mode is being played (instead of the selected level)
+    GLfloat                Scroll; // Top edge of the view in world space (0 unless in endless mode)
+    GLboolean              Autoplay; // Whether the paddle follows the ball by itself (for unattended runs)
+    GLfloat                Time; // Seconds of game time elapsed (sum of all update steps)
 	std::vector<PowerUp>  PowerUps;
     // Constructor/Destructor
     Game(GLuint width, GLuint height);
     ~Game();
-    // Initialize game state (load all shaders/textures/levels)
+    // Destroys the renderers, levels and audio; call while the GL context and the ResourceManager are still alive (the game is a global, destroyed after both)
+    void Shutdown();
+    // Initialize game state (starts loading all shaders/textures/levels; the game shows the loading screen until they are loaded)
     void Init();
-	// Resize Game window
-	void Resize(GLuint width, GLuint height) { this->Width = width; this->Height = height; }
+    // Waits for all assets to load and enters the menu
+    void FinishLoading();
+    // Starts a game in endless mode
+    void StartEndless();
+	// Resize Game window (the canvas is letterboxed into it)
+	void Resize(GLuint width, GLuint height);
     // GameLoop
     void ProcessInput(GLfloat dt);
     void Update(GLfloat dt);
     void Render();
 	void DoCollisions();
+	// Moves the world (and the view along with it) vertically by offset; the scene looks the same afterwards
+	void ShiftWorld(GLfloat offset);
 	// Reset
 	void ResetLevel();
 	void ResetPlayer();
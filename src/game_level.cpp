@@ -7,41 +7,79 @@
 ** option) any later version.
 ******************************************************************/
 #include "game_level.hpp"
+#include "resource_manager.hpp"
 
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
 
 
 void GameLevel::Load(const GLchar *file, GLuint levelWidth, GLuint levelHeight)
+{
+    // Load from file
+    LevelData data;
+    Read(file, data);
+    this->Load(data, levelWidth, levelHeight, ResourceManager::GetTexture("block_solid"), ResourceManager::GetTexture("block"));
+}
+
+void GameLevel::Load(const LevelData &data, GLuint levelWidth, GLuint levelHeight, TextureView solid, TextureView block)
 {
     // Clear old data
     this->Bricks.clear();
-    // Load from file
-    GLuint tileCode;
-    GameLevel level;
-    std::string line;
-    std::ifstream fstream(file);
-    std::vector<std::vector<GLuint>> tileData;
-    if (fstream)
+    if (data.Width > 0 && data.Height > 0)
+        this->init(data, levelWidth, levelHeight, solid, block);
+    this->pristine = this->Bricks;
+}
+
+GLboolean GameLevel::Read(const GLchar *file, LevelData &data)
+{
+    if (!ResourceManager::ReadAsset(file, data.Asset))
+        return GL_FALSE;
+    // Binary levels are used in place (they are mapped, from the pack or as large files)
+    const LevelHeader *header = reinterpret_cast<const LevelHeader*>(data.Asset.Data);
+    if (data.Asset.Size < static_cast<GLsizeiptr>(sizeof(LevelHeader)) || header->Magic != LEVEL_MAGIC)
+        return parseText(data);
+    GLuint64 tiles = static_cast<GLuint64>(header->Width) * header->Height;
+    GLuint64 size = (header->Flags & LEVEL_TILE_COLORS) ? LevelColorOffset(tiles) + tiles * sizeof(LevelTileColor) : sizeof(LevelHeader) + tiles;
+    if (header->Version != LEVEL_VERSION || size > static_cast<GLuint64>(data.Asset.Size))
     {
-        while (std::getline(fstream, line)) // Read each line from level file
-        {
-            std::istringstream sstream(line);
-            std::vector<GLuint> row;
-            while (sstream >> tileCode) // Read each word seperated by spaces
-                row.push_back(tileCode);
-            tileData.push_back(row);
-        }
-        if (tileData.size() > 0)
-            this->init(tileData, levelWidth, levelHeight);
+        std::cout << "ERROR::LEVEL: " << file << " is truncated or of an unsupported version" << std::endl;
+        return GL_FALSE;
     }
+    data.Width = header->Width;
+    data.Height = header->Height;
+    data.Tiles = data.Asset.Data + sizeof(LevelHeader);
+    data.Colors = (header->Flags & LEVEL_TILE_COLORS) ? reinterpret_cast<const LevelTileColor*>(data.Asset.Data + LevelColorOffset(tiles)) : nullptr;
+    return GL_TRUE;
+}
+
+void GameLevel::Reset()
+{
+    // Bricks always has the template's size, so this copies in place
+    this->Bricks.assign(this->pristine.begin(), this->pristine.end());
 }
 
-void GameLevel::Draw(SpriteRenderer &renderer)
+void GameLevel::Draw(RenderQueue &queue)
 {
     for (GameObject &tile : this->Bricks)
         if (!tile.Destroyed)
-            tile.Draw(renderer);
+            tile.Draw(queue, LAYER_LEVEL);
+}
+
+glm::vec3 GameLevel::TileColor(GLubyte code)
+{
+    glm::vec3 color = glm::vec3(1.0f); // original: white
+    if (code == 1) // Solid
+        color = glm::vec3(0.8f, 0.8f, 0.7f);
+    else if (code == 2) // Non-solid; now determine its color based on level data
+        color = glm::vec3(0.2f, 0.6f, 1.0f);
+    else if (code == 3)
+        color = glm::vec3(0.0f, 0.7f, 0.0f);
+    else if (code == 4)
+        color = glm::vec3(0.8f, 0.8f, 0.4f);
+    else if (code == 5)
+        color = glm::vec3(1.0f, 0.5f, 0.0f);
+    return color;
 }
 
 GLboolean GameLevel::IsCompleted()
@@ -52,46 +90,72 @@ GLboolean GameLevel::IsCompleted()
     return GL_TRUE;
 }
 
-void GameLevel::init(std::vector<std::vector<GLuint>> tileData, GLuint levelWidth, GLuint levelHeight)
+void GameLevel::init(const LevelData &data, GLuint levelWidth, GLuint levelHeight, TextureView solid, TextureView block)
 {
     // Calculate dimensions
-    GLuint height = tileData.size();
-    GLuint width = tileData[0].size(); // Note we can index vector at [0] since this function is only called if height > 0
-    GLfloat unit_width = levelWidth / static_cast<GLfloat>(width), unit_height = levelHeight / height; 
-    // Initialize level tiles based on tileData		
-    for (GLuint y = 0; y < height; ++y)
+    GLfloat unit_width = levelWidth / static_cast<GLfloat>(data.Width), unit_height = levelHeight / data.Height; 
+    glm::vec2 size(unit_width, unit_height);
+    // Allocate all bricks at once
+    GLuint64 tiles = static_cast<GLuint64>(data.Width) * data.Height;
+    this->Bricks.reserve(tiles - std::count(data.Tiles, data.Tiles + tiles, 0));
+    // Initialize level tiles based on tile data
+    for (GLuint y = 0; y < data.Height; ++y)
     {
-        for (GLuint x = 0; x < width; ++x)
+        for (GLuint x = 0; x < data.Width; ++x)
         {
             // Check block type from level data (2D level array)
-            if (tileData[y][x] == 1) // Solid
-            {
-                glm::vec2 pos(unit_width * x, unit_height * y);
-                glm::vec2 size(unit_width, unit_height);
-                GameObject obj(pos, size, ResourceManager::GetTexture("block_solid"), glm::vec3(0.8f, 0.8f, 0.7f));
-                obj.IsSolid = GL_TRUE;
-                this->Bricks.push_back(obj);
-            }
-            else if (tileData[y][x] > 1)	// Non-solid; now determine its color based on level data
-            {
-                glm::vec3 color = glm::vec3(1.0f); // original: white
-                if (tileData[y][x] == 2)
-                    color = glm::vec3(0.2f, 0.6f, 1.0f);
-                else if (tileData[y][x] == 3)
-                    color = glm::vec3(0.0f, 0.7f, 0.0f);
-                else if (tileData[y][x] == 4)
-                    color = glm::vec3(0.8f, 0.8f, 0.4f);
-                else if (tileData[y][x] == 5)
-                    color = glm::vec3(1.0f, 0.5f, 0.0f);
+            GLuint tile = y * data.Width + x;
+            GLubyte code = data.Tiles[tile];
+            if (code == 0)
+                continue;
+            glm::vec3 color = TileColor(code);
+            if (data.Colors != nullptr && data.Colors[tile].Alpha != 0)
+                color = glm::vec3(data.Colors[tile].Red, data.Colors[tile].Green, data.Colors[tile].Blue) / 255.0f;
 
-                glm::vec2 pos(unit_width * x, unit_height * y);
-                glm::vec2 size(unit_width, unit_height);
-                this->Bricks.push_back(GameObject(pos, size, ResourceManager::GetTexture("block"), color));
-            }
+            glm::vec2 pos(unit_width * x, unit_height * y);
+            this->Bricks.push_back(GameObject(pos, size, code == 1 ? solid : block, color));
+            this->Bricks.back().IsSolid = code == 1;
         }
     }
 }
 
+GLboolean GameLevel::parseText(LevelData &data)
+{
+    // Parsed in place (the asset is zero-terminated); every row is as wide as the first
+    const char *cursor = reinterpret_cast<const char*>(data.Asset.Data);
+    const char *end = cursor + data.Asset.Size;
+    data.Storage.clear();
+    data.Width = data.Height = 0;
+    while (cursor < end) // Read each line from level file
+    {
+        const char *lineEnd = std::find(cursor, end, '\n');
+        GLuint columns = 0;
+        while (cursor < lineEnd) // Read each word seperated by spaces
+        {
+            char *next;
+            GLuint tileCode = std::strtoul(cursor, &next, 10);
+            if (next == cursor || next > lineEnd)
+                break;
+            if (data.Height == 0 || columns < data.Width)
+                data.Storage.push_back(static_cast<GLubyte>(tileCode));
+            ++columns;
+            cursor = next;
+        }
+        if (columns > 0)
+        {
+            if (data.Height == 0)
+                data.Width = columns;
+            else if (columns < data.Width)
+                data.Storage.resize(data.Storage.size() + data.Width - columns, 0);
+            ++data.Height;
+        }
+        cursor = lineEnd + 1;
+    }
+    data.Tiles = data.Storage.data();
+    data.Colors = nullptr;
+    return GL_TRUE;
+}
+
 GLuint GameLevel::CountBlocks(GLboolean solid)
 {
 	GLuint num_blocks = 0;
@@ -14,8 +14,23 @@
 #include <glm/glm.hpp>
 
 #include "game_object.hpp"
-#include "sprite_renderer.hpp"
+#include "render_queue.hpp"
 #include "resource_manager.hpp"
+#include "level_format.hpp"
+
+
+/// Tiles of a level as read by GameLevel::Read: Width * Height tile
+/// codes row by row, and optionally a color per tile. For binary
+/// levels they point straight into the level asset; text levels are
+/// parsed into Storage.
+struct LevelData {
+    GLuint                Width, Height;
+    const GLubyte        *Tiles;
+    const LevelTileColor *Colors; // nullptr if the level has none
+    AssetView             Asset;
+    std::vector<GLubyte>  Storage;
+    LevelData() : Width(0), Height(0), Tiles(nullptr), Colors(nullptr) { }
+};
 
 
 /// GameLevel holds all Tiles as part of a Breakout level and 
@@ -27,17 +42,29 @@ public:
     std::vector<GameObject> Bricks;
     // Constructor
     GameLevel() { }
-    // Loads level from file
+    // Loads level from file (binary .blvl or text .lvl)
     void      Load(const GLchar *file, GLuint levelWidth, GLuint levelHeight);
+    // Loads level from tile data read by Read, with the given block textures (touches neither OpenGL nor the resource manager, so it may be called from any thread)
+    void      Load(const LevelData &data, GLuint levelWidth, GLuint levelHeight, TextureView solid, TextureView block);
+    // Reads the tiles of a level file without touching OpenGL, so it may be called from any thread
+    static GLboolean Read(const GLchar *file, LevelData &data);
+    // Restores the bricks to their state right after loading (allocation-free)
+    void      Reset();
+    // Color of bricks with the given tile code (unless the level specifies its own)
+    static glm::vec3 TileColor(GLubyte code);
     // Render level
-    void      Draw(SpriteRenderer &renderer);
+    void      Draw(RenderQueue &queue);
     // Check if the level is completed (all non-solid tiles are destroyed)
     GLboolean IsCompleted();
 	// Number of blocks
 	GLuint	  CountBlocks(GLboolean solid = GL_TRUE);
 private:
+    // Bricks as loaded, to reset the level from
+    std::vector<GameObject> pristine;
     // Initialize level from tile data
-    void      init(std::vector<std::vector<GLuint>> tileData, GLuint levelWidth, GLuint levelHeight);
+    void      init(const LevelData &data, GLuint levelWidth, GLuint levelHeight, TextureView solid, TextureView block);
+    // Parses a text level (a row of space separated tile codes per line)
+    static GLboolean parseText(LevelData &data);
 };
 
 #endif
\ No newline at end of file
@@ -12,10 +12,10 @@
 GameObject::GameObject() 
     : Position(0, 0), Size(1, 1), Velocity(0.0f), Color(1.0f), Rotation(0.0f), Sprite(), IsSolid(false), Destroyed(false) { }
 
-GameObject::GameObject(glm::vec2 pos, glm::vec2 size, Texture2D sprite, glm::vec3 color, glm::vec2 velocity) 
+GameObject::GameObject(glm::vec2 pos, glm::vec2 size, TextureView sprite, glm::vec3 color, glm::vec2 velocity) 
     : Position(pos), Size(size), Velocity(velocity), Color(color), Rotation(0.0f), Sprite(sprite), IsSolid(false), Destroyed(false) { }
 
-void GameObject::Draw(SpriteRenderer &renderer)
+void GameObject::Draw(RenderQueue &queue, RenderLayer layer)
 {
-    renderer.DrawSprite(this->Sprite, this->Position, this->Size, this->Rotation, this->Color);
+    queue.SubmitSprite(layer, this->Sprite, this->Position, this->Size, this->Rotation, this->Color);
 }
\ No newline at end of file
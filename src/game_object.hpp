@@ -13,7 +13,7 @@
 #include <glm/glm.hpp>
 
 #include "texture.hpp"
-#include "sprite_renderer.hpp"
+#include "render_queue.hpp"
 
 
 // Container object for holding all state relevant for a single
@@ -29,12 +29,12 @@ public:
     GLboolean   IsSolid;
     GLboolean   Destroyed;
     // Render state
-    Texture2D   Sprite;	
+    TextureView Sprite;	
     // Constructor(s)
     GameObject();
-    GameObject(glm::vec2 pos, glm::vec2 size, Texture2D sprite, glm::vec3 color = glm::vec3(1.0f), glm::vec2 velocity = glm::vec2(0.0f, 0.0f));
-    // Draw sprite
-    virtual void Draw(SpriteRenderer &renderer);
+    GameObject(glm::vec2 pos, glm::vec2 size, TextureView sprite, glm::vec3 color = glm::vec3(1.0f), glm::vec2 velocity = glm::vec2(0.0f, 0.0f));
+    // Queue sprite for rendering on the given layer
+    virtual void Draw(RenderQueue &queue, RenderLayer layer);
 };
 
 #endif
\ No newline at end of file
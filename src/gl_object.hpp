@@ -0,0 +1,92 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef GL_OBJECT_H
+#define GL_OBJECT_H
+
+#include <GL/glew.h>
+
+#include "gl_state.hpp"
+
+
+// GLObject owns the name of an OpenGL object and deletes it (with
+// Delete) when destroyed. It can be moved but not copied, so every
+// object has exactly one owner and is deleted exactly once; code
+// that only uses the object passes the name (ID) around instead.
+// Owners must be destroyed while the context is current (see
+// Game::Shutdown), never from static destructors.
+template <void (*Delete)(GLuint)>
+class GLObject
+{
+public:
+    // Name of the owned object (0: none)
+    GLuint ID;
+    // Constructor (takes ownership of the given name)/Destructor
+    GLObject() : ID(0) { }
+    explicit GLObject(GLuint id) : ID(id) { }
+    ~GLObject() { this->Reset(); }
+    GLObject(GLObject &&other) noexcept : ID(other.ID) { other.ID = 0; }
+    GLObject &operator=(GLObject &&other) noexcept
+    {
+        if (this != &other)
+        {
+            this->Reset(other.ID);
+            other.ID = 0;
+        }
+        return *this;
+    }
+    GLObject(const GLObject &) = delete;
+    GLObject &operator=(const GLObject &) = delete;
+    // Deletes the owned object, if any, and takes ownership of the given name
+    void Reset(GLuint id = 0)
+    {
+        if (this->ID != 0)
+            Delete(this->ID);
+        this->ID = id;
+    }
+};
+
+typedef GLObject<GLState::DeleteTexture>      TextureObject;
+typedef GLObject<GLState::DeleteBuffer>       BufferObject;
+typedef GLObject<GLState::DeleteVertexArray>  VertexArrayObject;
+typedef GLObject<GLState::DeleteFramebuffer>  FramebufferObject;
+typedef GLObject<GLState::DeleteRenderbuffer> RenderbufferObject;
+
+// Create a new object of each kind
+inline TextureObject GenTexture()
+{
+    GLuint id;
+    glGenTextures(1, &id);
+    return TextureObject(id);
+}
+inline BufferObject GenBuffer()
+{
+    GLuint id;
+    glGenBuffers(1, &id);
+    return BufferObject(id);
+}
+inline VertexArrayObject GenVertexArray()
+{
+    GLuint id;
+    glGenVertexArrays(1, &id);
+    return VertexArrayObject(id);
+}
+inline FramebufferObject GenFramebuffer()
+{
+    GLuint id;
+    glGenFramebuffers(1, &id);
+    return FramebufferObject(id);
+}
+inline RenderbufferObject GenRenderbuffer()
+{
+    GLuint id;
+    glGenRenderbuffers(1, &id);
+    return RenderbufferObject(id);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,195 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "gl_state.hpp"
+
+// Marks a shadowed binding as unknown
+static const GLuint UNKNOWN = ~0u;
+
+// Instantiate static variables (initialized to the defaults of a fresh context)
+GLuint64 GLState::Issued = 0;
+GLuint64 GLState::Elided = 0;
+GLuint   GLState::DefaultFramebuffer = 0;
+GLuint   GLState::program = 0;
+GLuint   GLState::activeUnit = 0;
+GLuint   GLState::textures[GL_STATE_TEXTURE_UNITS] = { 0 };
+GLuint   GLState::vertexArray = 0;
+GLuint   GLState::arrayBuffer = 0;
+GLuint   GLState::uniformBuffer = 0;
+GLuint   GLState::readFramebuffer = 0;
+GLuint   GLState::drawFramebuffer = 0;
+GLenum   GLState::blendSrc = GL_ONE;
+GLenum   GLState::blendDst = GL_ZERO;
+
+
+void GLState::UseProgram(GLuint program)
+{
+    if (change(GLState::program, program))
+        glUseProgram(program);
+}
+
+void GLState::ActiveTexture(GLenum unit)
+{
+    if (change(activeUnit, unit - GL_TEXTURE0))
+        glActiveTexture(unit);
+}
+
+void GLState::BindTexture(GLenum target, GLuint texture)
+{
+    // Only 2D textures are used by the game; other targets are passed through untracked
+    if (target != GL_TEXTURE_2D || activeUnit >= GL_STATE_TEXTURE_UNITS)
+    {
+        ++Issued;
+        glBindTexture(target, texture);
+    }
+    else if (change(textures[activeUnit], texture))
+        glBindTexture(target, texture);
+}
+
+void GLState::BindVertexArray(GLuint vao)
+{
+    if (change(vertexArray, vao))
+        glBindVertexArray(vao);
+}
+
+void GLState::BindBuffer(GLenum target, GLuint buffer)
+{
+    GLuint *slot = bufferSlot(target);
+    if (slot == nullptr)
+    {
+        ++Issued;
+        glBindBuffer(target, buffer);
+    }
+    else if (change(*slot, buffer))
+        glBindBuffer(target, buffer);
+}
+
+void GLState::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    // Indexed binds also replace the generic binding point of the target
+    ++Issued;
+    glBindBufferBase(target, index, buffer);
+    if (GLuint *slot = bufferSlot(target))
+        *slot = buffer;
+}
+
+void GLState::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    if (framebuffer == 0)
+        framebuffer = DefaultFramebuffer;
+    if (target == GL_READ_FRAMEBUFFER)
+    {
+        if (change(readFramebuffer, framebuffer))
+            glBindFramebuffer(target, framebuffer);
+    }
+    else if (target == GL_DRAW_FRAMEBUFFER)
+    {
+        if (change(drawFramebuffer, framebuffer))
+            glBindFramebuffer(target, framebuffer);
+    }
+    else if (readFramebuffer != framebuffer || drawFramebuffer != framebuffer)
+    {
+        readFramebuffer = drawFramebuffer = framebuffer;
+        ++Issued;
+        glBindFramebuffer(target, framebuffer);
+    }
+    else
+        ++Elided;
+}
+
+void GLState::BlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    if (blendSrc != sfactor || blendDst != dfactor)
+    {
+        blendSrc = sfactor;
+        blendDst = dfactor;
+        ++Issued;
+        glBlendFunc(sfactor, dfactor);
+    }
+    else
+        ++Elided;
+}
+
+void GLState::DeleteProgram(GLuint program)
+{
+    // A deleted program stays in use until another one is made current, so its binding stays valid
+    glDeleteProgram(program);
+}
+
+void GLState::DeleteTexture(GLuint texture)
+{
+    glDeleteTextures(1, &texture);
+    for (GLuint &bound : textures)
+        if (bound == texture)
+            bound = 0;
+}
+
+void GLState::DeleteVertexArray(GLuint vao)
+{
+    glDeleteVertexArrays(1, &vao);
+    if (vertexArray == vao)
+        vertexArray = 0;
+}
+
+void GLState::DeleteBuffer(GLuint buffer)
+{
+    glDeleteBuffers(1, &buffer);
+    if (arrayBuffer == buffer)
+        arrayBuffer = 0;
+    if (uniformBuffer == buffer)
+        uniformBuffer = 0;
+}
+
+void GLState::DeleteFramebuffer(GLuint framebuffer)
+{
+    glDeleteFramebuffers(1, &framebuffer);
+    if (readFramebuffer == framebuffer)
+        readFramebuffer = 0;
+    if (drawFramebuffer == framebuffer)
+        drawFramebuffer = 0;
+}
+
+void GLState::DeleteRenderbuffer(GLuint renderbuffer)
+{
+    glDeleteRenderbuffers(1, &renderbuffer);
+}
+
+void GLState::Invalidate()
+{
+    program = activeUnit = vertexArray = arrayBuffer = uniformBuffer = UNKNOWN;
+    readFramebuffer = drawFramebuffer = blendSrc = blendDst = UNKNOWN;
+    for (GLuint &bound : textures)
+        bound = UNKNOWN;
+}
+
+void GLState::ResetCounters()
+{
+    Issued = Elided = 0;
+}
+
+GLuint *GLState::bufferSlot(GLenum target)
+{
+    // Element array bindings are part of the vertex array state and are therefore not tracked here
+    if (target == GL_ARRAY_BUFFER)
+        return &arrayBuffer;
+    if (target == GL_UNIFORM_BUFFER)
+        return &uniformBuffer;
+    return nullptr;
+}
+
+GLboolean GLState::change(GLuint &current, GLuint value)
+{
+    if (current == value)
+    {
+        ++Elided;
+        return GL_FALSE;
+    }
+    current = value;
+    ++Issued;
+    return GL_TRUE;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <GL/glew.h>
+
+
+// Maximum number of texture units whose bindings are tracked
+const GLuint GL_STATE_TEXTURE_UNITS = 16;
+
+// A static singleton GLState class that shadows the binding state
+// of the OpenGL context. All binds go through it, so calls that
+// would set state that is already current are never issued to the
+// driver. It keeps count of how many calls were issued and elided.
+// Note that every bind/delete of a tracked object must go through
+// this class, otherwise the shadow copy goes out of sync.
+class GLState
+{
+public:
+    // Statistics
+    static GLuint64 Issued; // State calls passed on to the driver
+    static GLuint64 Elided; // State calls skipped because the state was already current
+    // Framebuffer that binds of framebuffer 0 are redirected to (e.g. an offscreen target when there is no window)
+    static GLuint   DefaultFramebuffer;
+    // Program/texture state
+    static void UseProgram(GLuint program);
+    static void ActiveTexture(GLenum unit);
+    static void BindTexture(GLenum target, GLuint texture);
+    // Vertex/buffer state
+    static void BindVertexArray(GLuint vao);
+    static void BindBuffer(GLenum target, GLuint buffer);
+    static void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    // Framebuffer state (GL_FRAMEBUFFER sets both the read and draw binding)
+    static void BindFramebuffer(GLenum target, GLuint framebuffer);
+    // Blend state
+    static void BlendFunc(GLenum sfactor, GLenum dfactor);
+    // Deletes objects and drops them from the shadowed bindings (GL reverts bindings of deleted objects to 0)
+    static void DeleteProgram(GLuint program);
+    static void DeleteTexture(GLuint texture);
+    static void DeleteVertexArray(GLuint vao);
+    static void DeleteBuffer(GLuint buffer);
+    static void DeleteFramebuffer(GLuint framebuffer);
+    static void DeleteRenderbuffer(GLuint renderbuffer); // (renderbuffer bindings aren't shadowed)
+    // Forgets all shadowed state, forcing the next call of each kind through (e.g. after third-party code touched the context)
+    static void Invalidate();
+    // Resets the statistics
+    static void ResetCounters();
+private:
+    // Private constructor, that is we do not want any actual GLState objects. Its members and functions should be publicly available (static).
+    GLState() { }
+    // Shadowed state; ~0 marks a binding as unknown
+    static GLuint program;
+    static GLuint activeUnit;
+    static GLuint textures[GL_STATE_TEXTURE_UNITS];
+    static GLuint vertexArray;
+    static GLuint arrayBuffer, uniformBuffer;
+    static GLuint readFramebuffer, drawFramebuffer;
+    static GLenum blendSrc, blendDst;
+    // Returns the shadow slot of the given buffer target (nullptr if untracked)
+    static GLuint *bufferSlot(GLenum target);
+    // Updates a shadowed value, returns whether the call must be issued
+    static GLboolean change(GLuint &current, GLuint value);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "gpu_timer.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+
+// Instantiate static variables
+GLboolean                           GpuTimer::Enabled = GL_TRUE;
+std::map<std::string, GpuTimerPass> GpuTimer::passes;
+std::vector<std::string>            GpuTimer::order;
+GLuint                              GpuTimer::frame = 0;
+
+
+void GpuTimer::Begin(const std::string &pass)
+{
+    if (!Enabled)
+        return;
+    std::map<std::string, GpuTimerPass>::iterator it = passes.find(pass);
+    if (it == passes.end())
+    {
+        // First use of this pass: create its queries
+        GpuTimerPass timer = GpuTimerPass();
+        glGenQueries(GPU_TIMER_LATENCY * 2, &timer.Queries[0][0]);
+        it = passes.insert(std::make_pair(pass, timer)).first;
+        order.push_back(pass);
+    }
+    glQueryCounter(it->second.Queries[frame][0], GL_TIMESTAMP);
+}
+
+void GpuTimer::End(const std::string &pass)
+{
+    if (!Enabled)
+        return;
+    std::map<std::string, GpuTimerPass>::iterator it = passes.find(pass);
+    if (it == passes.end())
+        return; // Never begun
+    glQueryCounter(it->second.Queries[frame][1], GL_TIMESTAMP);
+    it->second.Issued[frame] = GL_TRUE;
+}
+
+void GpuTimer::EndFrame()
+{
+    // The next slot was issued GPU_TIMER_LATENCY - 1 frames ago; collect it before it gets reused
+    frame = (frame + 1) % GPU_TIMER_LATENCY;
+    for (std::map<std::string, GpuTimerPass>::iterator it = passes.begin(); it != passes.end(); ++it)
+    {
+        GpuTimerPass &timer = it->second;
+        if (!timer.Issued[frame])
+        {
+            timer.Milliseconds = 0.0f; // Pass did not run that frame
+            continue;
+        }
+        timer.Issued[frame] = GL_FALSE;
+        GLint available = 0;
+        glGetQueryObjectiv(timer.Queries[frame][1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue; // Still in flight; keep the previous value rather than wait for it
+        GLuint64 begin, end;
+        glGetQueryObjectui64v(timer.Queries[frame][0], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(timer.Queries[frame][1], GL_QUERY_RESULT, &end);
+        timer.Milliseconds = (end - begin) / 1000000.0f;
+    }
+}
+
+GLfloat GpuTimer::Milliseconds(const std::string &pass)
+{
+    std::map<std::string, GpuTimerPass>::iterator it = passes.find(pass);
+    return it != passes.end() ? it->second.Milliseconds : 0.0f;
+}
+
+std::string GpuTimer::Report()
+{
+    std::stringstream report;
+    report << std::fixed << std::setprecision(3);
+    for (GLuint i = 0; i < order.size(); ++i)
+        report << (i ? " | " : "") << order[i] << " " << passes[order[i]].Milliseconds << "ms";
+    return report.str();
+}
+
+void GpuTimer::Clear()
+{
+    for (std::map<std::string, GpuTimerPass>::iterator it = passes.begin(); it != passes.end(); ++it)
+        glDeleteQueries(GPU_TIMER_LATENCY * 2, &it->second.Queries[0][0]);
+    passes.clear();
+    order.clear();
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+#include <map>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+
+// Number of frames of queries kept in flight; results are read this many frames after they were issued
+const GLuint GPU_TIMER_LATENCY = 3;
+
+// Timestamp queries of a single render pass, one pair per in-flight frame
+struct GpuTimerPass {
+    GLuint    Queries[GPU_TIMER_LATENCY][2]; // <begin, end> timestamp per frame
+    GLboolean Issued[GPU_TIMER_LATENCY];     // Whether both queries of a frame were issued
+    GLfloat   Milliseconds;                  // GPU time of the most recent resolved frame
+};
+
+// A static singleton GpuTimer class that measures the GPU time of
+// named render passes. Each Begin/End pair records a GL_TIMESTAMP
+// query (timestamps, unlike GL_TIME_ELAPSED, may nest and overlap).
+// Queries are cycled through GPU_TIMER_LATENCY frames and only read
+// once the GPU reports them available, so timing never stalls the
+// pipeline. Call GpuTimer::EndFrame() once after the last pass.
+class GpuTimer
+{
+public:
+    // Whether queries are issued at all
+    static GLboolean Enabled;
+    // Marks the start/end of the named pass in the command stream
+    static void    Begin(const std::string &pass);
+    static void    End(const std::string &pass);
+    // Moves on to the next frame and collects the results of the oldest one
+    static void    EndFrame();
+    // Returns the GPU time of the given pass in milliseconds (0 if it did not run)
+    static GLfloat Milliseconds(const std::string &pass);
+    // Returns a single line listing the GPU time of every pass, in order of first use
+    static std::string Report();
+    // Releases all query objects
+    static void    Clear();
+private:
+    // Timed passes, and their names in order of first use
+    static std::map<std::string, GpuTimerPass> passes;
+    static std::vector<std::string>            order;
+    // Query slot written this frame
+    static GLuint                              frame;
+    // Private constructor, that is we do not want any actual timer objects. Its members and functions should be publicly available (static).
+    GpuTimer() { }
+};
+
+#endif
\ No newline at end of file
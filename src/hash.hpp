@@ -0,0 +1,40 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef HASH_H
+#define HASH_H
+#include <cstddef>
+#include <string>
+
+#include <GL/glew.h>
+
+
+// 64 bit FNV-1a parameters
+const GLuint64 FNV_OFFSET_BASIS = 14695981039346656037ull;
+const GLuint64 FNV_PRIME        = 1099511628211ull;
+
+// Hashes size bytes with 64 bit FNV-1a. Pass the result of a previous
+// call as hash to continue hashing over several pieces of data.
+inline GLuint64 Fnv1a(const void *data, std::size_t size, GLuint64 hash = FNV_OFFSET_BASIS)
+{
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// Hashes a string including its terminator, so consecutive strings can't run into each other
+inline GLuint64 Fnv1a(const std::string &text, GLuint64 hash = FNV_OFFSET_BASIS)
+{
+    return Fnv1a(text.c_str(), text.size() + 1, hash);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifdef BREAKOUT_HEADLESS
+#include "headless.hpp"
+
+#include <iostream>
+
+#include <EGL/eglext.h>
+
+#include "gl_state.hpp"
+#include "image_writer.hpp"
+
+
+HeadlessContext::HeadlessContext(GLuint width, GLuint height)
+    : Width(width), Height(height), display(EGL_NO_DISPLAY), context(EGL_NO_CONTEXT)
+{
+    // Prefer the surfaceless platform (no X11/Wayland/GBM device needed), fall back to the default display
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay)
+        this->display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (this->display == EGL_NO_DISPLAY)
+        this->display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (this->display == EGL_NO_DISPLAY || !eglInitialize(this->display, nullptr, nullptr))
+    {
+        std::cout << "ERROR::HEADLESS: Failed to initialize EGL display" << std::endl;
+        this->display = EGL_NO_DISPLAY;
+        return;
+    }
+    // Pick any desktop GL capable config; nothing is ever rendered to an EGL surface
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configs = 0;
+    if (!eglBindAPI(EGL_OPENGL_API) || !eglChooseConfig(this->display, configAttribs, &config, 1, &configs) || configs == 0)
+    {
+        std::cout << "ERROR::HEADLESS: No EGL config supports desktop OpenGL" << std::endl;
+        return;
+    }
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    this->context = eglCreateContext(this->display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (this->context == EGL_NO_CONTEXT || !eglMakeCurrent(this->display, EGL_NO_SURFACE, EGL_NO_SURFACE, this->context))
+    {
+        std::cout << "ERROR::HEADLESS: Failed to create an OpenGL 3.3 core context" << std::endl;
+        this->context = EGL_NO_CONTEXT;
+    }
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    if (this->context != EGL_NO_CONTEXT)
+    {
+        GLState::DefaultFramebuffer = 0;
+        // Deleted now, while the context is still current
+        this->FBO.Reset();
+        this->RBO.Reset();
+        eglMakeCurrent(this->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(this->display, this->context);
+    }
+    if (this->display != EGL_NO_DISPLAY)
+        eglTerminate(this->display);
+}
+
+GLboolean HeadlessContext::Valid() const
+{
+    return this->context != EGL_NO_CONTEXT;
+}
+
+GLboolean HeadlessContext::Init()
+{
+    // A surfaceless context has no default framebuffer; render everything targeting framebuffer 0 into this one instead
+    this->FBO = GenFramebuffer();
+    this->RBO = GenRenderbuffer();
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, this->FBO.ID);
+    glBindRenderbuffer(GL_RENDERBUFFER, this->RBO.ID);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, this->Width, this->Height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->RBO.ID);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "ERROR::HEADLESS: Failed to initialize offscreen framebuffer" << std::endl;
+        return GL_FALSE;
+    }
+    GLState::DefaultFramebuffer = this->FBO.ID;
+    this->pixels.resize(this->Width * this->Height * 4);
+    return GL_TRUE;
+}
+
+GLboolean HeadlessContext::DumpFrame(const std::string &path)
+{
+    GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, this->Width, this->Height, GL_RGBA, GL_UNSIGNED_BYTE, this->pixels.data());
+    return ImageWriter::WritePPM(path, this->Width, this->Height, this->pixels.data(), 4);
+}
+
+#endif
\ No newline at end of file
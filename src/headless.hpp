@@ -0,0 +1,53 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef HEADLESS_H
+#define HEADLESS_H
+#ifdef BREAKOUT_HEADLESS
+#include <string>
+#include <vector>
+
+#include <EGL/egl.h>
+#include <GL/glew.h>
+
+#include "gl_object.hpp"
+
+
+// HeadlessContext creates an OpenGL 3.3 core context without any
+// window or display server (EGL on the surfaceless platform, which
+// Mesa's software rasterisers support) and an offscreen framebuffer
+// that stands in for the default framebuffer, so the regular render
+// path runs unmodified. Only available in BREAKOUT_HEADLESS builds.
+class HeadlessContext
+{
+public:
+    // State
+    GLuint Width, Height;
+    // Constructor/Destructor (makes the context current)
+    HeadlessContext(GLuint width, GLuint height);
+    ~HeadlessContext();
+    HeadlessContext(const HeadlessContext &) = delete;
+    HeadlessContext &operator=(const HeadlessContext &) = delete;
+    // Whether the context was created successfully
+    GLboolean Valid() const;
+    // Creates the offscreen framebuffer and redirects the default framebuffer to it; call after glewInit()
+    GLboolean Init();
+    // Reads back the offscreen framebuffer and writes it to the given path as a binary PPM
+    GLboolean DumpFrame(const std::string &path);
+private:
+    // EGL state
+    EGLDisplay display;
+    EGLContext context;
+    // Offscreen framebuffer
+    FramebufferObject  FBO;
+    RenderbufferObject RBO;
+    std::vector<unsigned char> pixels;
+};
+
+#endif
+#endif
\ No newline at end of file
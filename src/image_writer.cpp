@@ -0,0 +1,38 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "image_writer.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+
+GLboolean ImageWriter::WritePPM(const std::string &path, GLuint width, GLuint height, const unsigned char *pixels, GLuint channels)
+{
+    std::ofstream file(path.c_str(), std::ios::out | std::ios::binary);
+    if (!file)
+    {
+        std::cout << "ERROR::IMAGEWRITER: Failed to open " << path << std::endl;
+        return GL_FALSE;
+    }
+    file << "P6\n" << width << " " << height << "\n255\n";
+    std::vector<char> row(width * 3);
+    for (GLuint y = height; y-- > 0;)
+    {
+        const unsigned char *src = pixels + static_cast<size_t>(y) * width * channels;
+        for (GLuint x = 0; x < width; ++x)
+        {
+            row[x * 3 + 0] = src[x * channels + 0];
+            row[x * 3 + 1] = src[x * channels + 1];
+            row[x * 3 + 2] = src[x * channels + 2];
+        }
+        file.write(row.data(), row.size());
+    }
+    return file.good() ? GL_TRUE : GL_FALSE;
+}
\ No newline at end of file
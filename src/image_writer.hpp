@@ -0,0 +1,28 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef IMAGE_WRITER_H
+#define IMAGE_WRITER_H
+#include <string>
+
+#include <GL/glew.h>
+
+
+// A static singleton ImageWriter class that hosts functions to
+// write raw pixel data (as read back from OpenGL) to image files.
+class ImageWriter
+{
+public:
+    // Writes tightly packed RGB (or RGBA, alpha is dropped) pixels as a binary PPM; OpenGL's rows run bottom-up, so they are written in reverse
+    static GLboolean WritePPM(const std::string &path, GLuint width, GLuint height, const unsigned char *pixels, GLuint channels = 3);
+private:
+    // Private constructor, that is we do not want any actual writer objects. Its members and functions should be publicly available (static).
+    ImageWriter() { }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,100 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "level_catalogue.hpp"
+
+#include <iostream>
+
+#include "resource_manager.hpp"
+
+
+LevelCatalogue::LevelCatalogue(const std::string &directory, GLuint levelWidth, GLuint levelHeight)
+    : levelWidth(levelWidth), levelHeight(levelHeight), solid(ResourceManager::FindTexture("block_solid")), block(ResourceManager::FindTexture("block")), prefetched(-1), loader(1)
+{
+    // The bricks keep views of the block textures, so they are held for as long as there are levels
+    ResourceManager::AcquireTexture(this->solid);
+    ResourceManager::AcquireTexture(this->block);
+    std::vector<std::string> assets;
+    ResourceManager::ListAssets(directory, assets);
+    for (const std::string &asset : assets)
+    {
+        std::string::size_type extension = asset.rfind('.');
+        if (extension != std::string::npos && (asset.compare(extension, std::string::npos, ".lvl") == 0 || asset.compare(extension, std::string::npos, ".blvl") == 0))
+            this->paths.push_back(asset);
+    }
+    if (this->paths.empty())
+        std::cout << "ERROR::LEVELS: No levels found in " << directory << std::endl;
+}
+
+LevelCatalogue::~LevelCatalogue()
+{
+    ResourceManager::ReleaseTexture(this->solid);
+    ResourceManager::ReleaseTexture(this->block);
+}
+
+GLuint LevelCatalogue::Count() const
+{
+    return this->paths.size();
+}
+
+const std::string &LevelCatalogue::Path(GLuint index) const
+{
+    return this->paths[index];
+}
+
+GameLevel &LevelCatalogue::Get(GLuint index)
+{
+    if (this->levels.find(index) == this->levels.end())
+    {
+        // Not prefetched: load it on this thread rather than queue it behind the prefetches
+        std::shared_ptr<GameLevel> level = std::make_shared<GameLevel>();
+        level->Load(this->paths[index].c_str(), this->levelWidth, this->levelHeight);
+        std::promise<std::shared_ptr<GameLevel>> loaded;
+        loaded.set_value(level);
+        this->levels[index] = loaded.get_future().share();
+    }
+    return *this->levels[index].get();
+}
+
+void LevelCatalogue::Prefetch(GLuint index)
+{
+    GLuint count = this->Count();
+    if (count == 0 || this->prefetched == static_cast<GLint>(index))
+        return;
+    this->prefetched = index;
+    // Keep (or start loading) the given level and its neighbours; the catalogue wraps around
+    std::map<GLuint, PendingLevel> kept;
+    GLuint first = index + count - LEVEL_PREFETCH_RADIUS % count;
+    for (GLuint offset = 0; offset <= 2 * LEVEL_PREFETCH_RADIUS && offset < count; ++offset)
+    {
+        GLuint neighbour = (first + offset) % count;
+        this->load(neighbour);
+        kept[neighbour] = this->levels[neighbour];
+    }
+    // Levels still loading finish on the loader thread and are released there
+    this->levels.swap(kept);
+}
+
+void LevelCatalogue::load(GLuint index)
+{
+    if (this->levels.find(index) != this->levels.end())
+        return;
+    // The loader thread builds the whole level; the block textures are looked up here, on the context thread
+    std::shared_ptr<std::promise<std::shared_ptr<GameLevel>>> loaded = std::make_shared<std::promise<std::shared_ptr<GameLevel>>>();
+    this->levels[index] = loaded->get_future().share();
+    std::string path = this->paths[index];
+    GLuint width = this->levelWidth, height = this->levelHeight;
+    TextureView solid = ResourceManager::GetTexture(this->solid), block = ResourceManager::GetTexture(this->block);
+    this->loader.Submit([loaded, path, width, height, solid, block] {
+        LevelData data;
+        GameLevel::Read(path.c_str(), data);
+        std::shared_ptr<GameLevel> level = std::make_shared<GameLevel>();
+        level->Load(data, width, height, solid, block);
+        loaded->set_value(level);
+    });
+}
\ No newline at end of file
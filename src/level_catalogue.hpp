@@ -0,0 +1,61 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef LEVEL_CATALOGUE_H
+#define LEVEL_CATALOGUE_H
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "game_level.hpp"
+#include "thread_pool.hpp"
+
+
+// Directory the level catalogue is listed from
+#define LEVEL_DIRECTORY "assets/levels"
+// Number of levels on either side of the selected one that are prefetched
+const GLuint LEVEL_PREFETCH_RADIUS = 1;
+
+// LevelCatalogue lists the levels of a directory (loose files, pack
+// entries and embedded levels; ordered by file name) and loads them
+// on demand. Only the selected level and its neighbours are kept:
+// they are loaded on a background thread ahead of being selected,
+// and all other levels are dropped, so memory does not grow with
+// the size of the catalogue.
+class LevelCatalogue
+{
+public:
+    // Constructor (lists the levels; levels are laid out in the given area)/Destructor
+    LevelCatalogue(const std::string &directory, GLuint levelWidth, GLuint levelHeight);
+    ~LevelCatalogue();
+    // Number of levels in the catalogue
+    GLuint      Count() const;
+    // Path of the level at the given index
+    const std::string &Path(GLuint index) const;
+    // Returns the level at the given index, loading it right away unless it is loaded or being loaded already (then waits for it)
+    GameLevel  &Get(GLuint index);
+    // Starts loading the neighbours of the given level in the background, and drops all levels further away
+    void        Prefetch(GLuint index);
+private:
+    typedef std::shared_future<std::shared_ptr<GameLevel>> PendingLevel;
+    std::vector<std::string>      paths;
+    GLuint                        levelWidth, levelHeight;
+    TextureHandle                 solid, block; // Block textures (the levels copy them)
+    std::map<GLuint, PendingLevel> levels; // Loaded and loading levels
+    GLint                         prefetched; // Level the neighbours were last prefetched of (-1: none)
+    // Loader thread; declared last so it is stopped before the levels it loads into are destroyed
+    ThreadPool                    loader;
+    // Starts loading the given level on the loader thread (if it isn't already)
+    void        load(GLuint index);
+};
+
+#endif
\ No newline at end of file
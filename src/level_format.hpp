@@ -0,0 +1,49 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef LEVEL_FORMAT_H
+#define LEVEL_FORMAT_H
+
+#include <GL/glew.h>
+
+
+// Identifies a binary level ("BLVL")
+const GLuint LEVEL_MAGIC = 0x4C564C42;
+// Version of the level layout below
+const GLuint LEVEL_VERSION = 1;
+
+// Flags of a binary level
+enum LevelFlags {
+    LEVEL_TILE_COLORS = 1 // A color follows the tile codes for every tile
+};
+
+// Layout of a binary level (.blvl, written by the level converter
+// tool): the header, Width * Height tile codes of one byte each, row
+// by row (0: empty, 1: solid, 2-5: colored bricks), and with
+// LEVEL_TILE_COLORS a LevelTileColor per tile (starting at a 4 byte
+// aligned offset).
+struct LevelHeader {
+    GLuint Magic;
+    GLuint Version;
+    GLuint Width, Height; // In tiles
+    GLuint Flags;         // LevelFlags
+    GLuint Reserved;
+};
+
+// Per-tile color overriding the color of the tile code (if Alpha is not 0)
+struct LevelTileColor {
+    GLubyte Red, Green, Blue, Alpha;
+};
+
+// Offset of the tile colors of a binary level with the given number of tiles
+inline GLuint64 LevelColorOffset(GLuint64 tiles)
+{
+    return (sizeof(LevelHeader) + tiles + 3) / 4 * 4;
+}
+
+#endif
\ No newline at end of file
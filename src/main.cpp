@@ -7,31 +7,75 @@
 ** option) any later version.
 ******************************************************************/
 #define GLEW_STATIC
+#include <iostream>
+#include <string>
+#ifdef BREAKOUT_HEADLESS
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#endif
+
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
 #include "game.hpp"
 #include "resource_manager.hpp"
+#include "gl_state.hpp"
+#include "gpu_timer.hpp"
+#include "frame_capture.hpp"
+#ifdef BREAKOUT_HEADLESS
+#include "headless.hpp"
+#endif
 
 
 // GLFW function declarations
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
 void resize_window_callback(GLFWwindow* window, int width, int height);
+// Shared setup/teardown of the windowed and headless paths
+void configure_opengl();
+void configure_resources(int argc, char *argv[]);
+void shutdown();
+// Returns the value following the given command line option (empty if absent)
+std::string command_line_option(int argc, char *argv[], const std::string &name);
+#ifdef BREAKOUT_HEADLESS
+int run_headless(int argc, char *argv[]);
+#endif
 
 // The Width of the screen
 const GLuint SCREEN_WIDTH = 800;
 // The height of the screen
 const GLuint SCREEN_HEIGHT = 600;
+// Seconds between two log lines of per-pass GPU timings
+const GLfloat TIMING_LOG_INTERVAL = 5.0f;
+// Time step of headless runs; fixed so every run renders the same frames
+const GLfloat HEADLESS_TIME_STEP = 1.0f / 60.0f;
 
 Game Breakout(SCREEN_WIDTH, SCREEN_HEIGHT);
 
 int main(int argc, char *argv[])
 {
+    // Render offscreen without a window (benchmarks, reference images) when requested
+    for (int i = 1; i < argc; ++i)
+        if (std::string(argv[i]) == "--headless")
+        {
+#ifdef BREAKOUT_HEADLESS
+            return run_headless(argc, argv);
+#else
+            std::cout << "ERROR::MAIN: --headless requires a build with BREAKOUT_HEADLESS enabled" << std::endl;
+            return 1;
+#endif
+        }
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_RESIZABLE, GL_FALSE);
+    // Record every frame when requested (--capture out.y4m, or a file name prefix for a PPM sequence); the recording has a fixed size, so the window can't be resized meanwhile
+    std::string capturePath = command_line_option(argc, argv, "--capture");
+    glfwWindowHint(GLFW_RESIZABLE, capturePath.empty() ? GL_TRUE : GL_FALSE);
 
     GLFWwindow* window = glfwCreateWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Breakout", nullptr, nullptr);
     glfwMakeContextCurrent(window);
@@ -41,24 +85,25 @@ int main(int argc, char *argv[])
     glGetError(); // Call it once to catch glewInit() bug, all other errors are now from our application.
 
     glfwSetKeyCallback(window, key_callback);
-	glfwSetWindowSizeCallback(window, resize_window_callback);
-	
+    // Framebuffer size, not window size: they differ on high-DPI displays, and the viewport is in pixels
+    glfwSetFramebufferSizeCallback(window, resize_window_callback);
 
     // OpenGL configuration
-    glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
-    glEnable(GL_CULL_FACE);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    configure_opengl();
+    configure_resources(argc, argv);
 
-    // Initialize game
+    // Initialize game, laid out for the framebuffer the window actually got
     Breakout.Init();
+    int framebufferWidth, framebufferHeight;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    Breakout.Resize(framebufferWidth, framebufferHeight);
 
     // DeltaTime variables
     GLfloat deltaTime = 0.0f;
     GLfloat lastFrame = 0.0f;
+    GLfloat lastTimingLog = 0.0f;
 
-    // Start Game within Menu State
-    Breakout.State = GAME_MENU;
+    FrameCapture *capture = capturePath.empty() ? nullptr : new FrameCapture(capturePath, framebufferWidth, framebufferHeight);
 
     while (!glfwWindowShouldClose(window))
     {
@@ -75,20 +120,157 @@ int main(int argc, char *argv[])
         // Update Game state
         Breakout.Update(deltaTime);
 
-        // Render
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+        // Render (the game clears whichever target it renders the scene to)
         Breakout.Render();
+        GLfloat cpuTime = glfwGetTime() - currentFrame;
+        if (capture)
+            capture->Capture();
 
         glfwSwapBuffers(window);
+
+        // Periodically report GPU time per pass next to the CPU time spent on the frame (GPU >> CPU: fill-bound, otherwise submission-bound)
+        if (currentFrame - lastTimingLog >= TIMING_LOG_INTERVAL)
+        {
+            std::cout << "INFO::GPUTIMER: " << GpuTimer::Report() << " | cpu " << cpuTime * 1000.0f << "ms | textures "
+                << ResourceManager::TextureMemory() / 1024 << "KiB" << std::endl;
+            lastTimingLog = currentFrame;
+        }
     }
 
+    delete capture;
+    Breakout.Shutdown();
+    shutdown();
+
+    glfwTerminate();
+    return 0;
+}
+
+void configure_opengl()
+{
+    glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    glEnable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void configure_resources(int argc, char *argv[])
+{
+    // Cap the texture memory kept resident when requested (--texture-budget MiB, for machines with little memory)
+    std::string budget = command_line_option(argc, argv, "--texture-budget");
+    if (!budget.empty())
+        ResourceManager::SetTextureBudget(static_cast<GLsizeiptr>(std::atof(budget.c_str()) * 1024 * 1024));
+}
+
+void shutdown()
+{
+    // Report how much redundant state setting was kept away from the driver
+    std::cout << "INFO::GLSTATE: Elided " << GLState::Elided << " of "
+        << (GLState::Issued + GLState::Elided) << " state calls" << std::endl;
+
     // Delete all resources as loaded using the resource manager
     ResourceManager::Clear();
+    GpuTimer::Clear();
+}
 
-    glfwTerminate();
+std::string command_line_option(int argc, char *argv[], const std::string &name)
+{
+    for (int i = 1; i + 1 < argc; ++i)
+        if (name == argv[i])
+            return argv[i + 1];
+    return "";
+}
+
+#ifdef BREAKOUT_HEADLESS
+// Usage: breakout --headless [--frames N] [--dump N,N,...] [--dump-every N] [--output DIR] [--capture PATH] [--play] [--endless] [--autoplay] [--dynamic-resolution]
+int run_headless(int argc, char *argv[])
+{
+    GLuint frames = 600, dumpEvery = 0;
+    std::set<GLuint> dumps;
+    std::string output = ".";
+    GLboolean play = GL_FALSE, endless = GL_FALSE, autoplay = GL_FALSE, dynamicResolution = GL_FALSE;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc)
+            frames = std::atoi(argv[++i]);
+        else if (arg == "--dump" && i + 1 < argc)
+        {
+            std::stringstream list(argv[++i]);
+            std::string frame;
+            while (std::getline(list, frame, ','))
+                dumps.insert(std::atoi(frame.c_str()));
+        }
+        else if (arg == "--dump-every" && i + 1 < argc)
+            dumpEvery = std::atoi(argv[++i]);
+        else if (arg == "--output" && i + 1 < argc)
+            output = argv[++i];
+        else if (arg == "--play")
+            play = GL_TRUE;
+        else if (arg == "--endless")
+            endless = GL_TRUE;
+        else if (arg == "--autoplay")
+            autoplay = GL_TRUE;
+        else if (arg == "--dynamic-resolution")
+            dynamicResolution = GL_TRUE;
+    }
+
+    HeadlessContext context(SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (!context.Valid())
+        return 1;
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK)
+    {
+        std::cout << "ERROR::HEADLESS: glewInit failed (GLEW must be built with GLEW_EGL)" << std::endl;
+        return 1;
+    }
+    glGetError();
+    if (!context.Init())
+        return 1;
+    configure_opengl();
+    configure_resources(argc, argv);
+
+    Breakout.Init();
+    // Load everything up front, so the first rendered frame is the same in every run
+    Breakout.FinishLoading();
+    // Either sit in the menu or start playing with the ball launched right away (--endless --autoplay --frames N is the soak test)
+    Breakout.State = play ? GAME_ACTIVE : GAME_MENU;
+    if (endless)
+        Breakout.StartEndless();
+    Breakout.Keys[GLFW_KEY_SPACE] = play || endless;
+    Breakout.Autoplay = autoplay;
+    // Render at full resolution unless asked otherwise, so runs are reproducible
+    Breakout.DynamicResolution = dynamicResolution;
+    std::string capturePath = command_line_option(argc, argv, "--capture");
+    FrameCapture *capture = capturePath.empty() ? nullptr : new FrameCapture(capturePath, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (GLuint frame = 0; frame < frames; ++frame)
+    {
+        Breakout.ProcessInput(HEADLESS_TIME_STEP);
+        Breakout.Update(HEADLESS_TIME_STEP);
+        Breakout.Render();
+        if (dumps.count(frame) || (dumpEvery && frame % dumpEvery == 0))
+        {
+            std::stringstream path;
+            path << output << "/frame_" << std::setw(5) << std::setfill('0') << frame << ".ppm";
+            context.DumpFrame(path.str());
+        }
+        if (capture)
+            capture->Capture();
+    }
+    glFinish();
+    GLfloat elapsed = std::chrono::duration<GLfloat, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "INFO::HEADLESS: Rendered " << frames << " frames in " << elapsed << "ms ("
+        << elapsed / std::max(frames, 1u) << "ms per frame)" << std::endl;
+    std::cout << "INFO::GPUTIMER: " << GpuTimer::Report() << std::endl;
+    std::cout << "INFO::RESOURCES: " << ResourceManager::TextureMemory() / 1024 << "KiB of textures resident" << std::endl;
+
+    delete capture;
+    Breakout.Shutdown();
+    shutdown();
     return 0;
 }
+#endif
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode)
 {
@@ -109,6 +291,5 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 
 void resize_window_callback(GLFWwindow* window, int width, int height)
 {
-	glViewport(0, 0, width, height);
 	Breakout.Resize(width, height);
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+MappedFile::MappedFile()
+    : Data(nullptr), Size(0)
+#ifdef _WIN32
+    , file(INVALID_HANDLE_VALUE), mapping(nullptr)
+#endif
+{
+
+}
+
+MappedFile::~MappedFile()
+{
+    this->Close();
+}
+
+GLboolean MappedFile::Open(const std::string &path)
+{
+    this->Close();
+#ifdef _WIN32
+    this->file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (this->file == INVALID_HANDLE_VALUE)
+        return GL_FALSE;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(this->file, &size) || size.QuadPart == 0)
+    {
+        this->Close();
+        return GL_FALSE;
+    }
+    this->mapping = CreateFileMappingA(this->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void *view = this->mapping ? MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr)
+    {
+        this->Close();
+        return GL_FALSE;
+    }
+    this->Data = static_cast<const unsigned char*>(view);
+    this->Size = static_cast<GLsizeiptr>(size.QuadPart);
+#else
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return GL_FALSE;
+    struct stat status;
+    void *view = MAP_FAILED;
+    if (fstat(descriptor, &status) == 0 && status.st_size > 0)
+        view = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor); // The mapping keeps the file open
+    if (view == MAP_FAILED)
+        return GL_FALSE;
+    // Read the whole file ahead in one go instead of faulting it in page by page
+    madvise(view, status.st_size, MADV_SEQUENTIAL);
+    madvise(view, status.st_size, MADV_WILLNEED);
+    this->Data = static_cast<const unsigned char*>(view);
+    this->Size = static_cast<GLsizeiptr>(status.st_size);
+#endif
+    return GL_TRUE;
+}
+
+GLsizeiptr MappedFile::PageSize()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return sysconf(_SC_PAGESIZE);
+#endif
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (this->Data != nullptr)
+        UnmapViewOfFile(this->Data);
+    if (this->mapping != nullptr)
+        CloseHandle(this->mapping);
+    if (this->file != INVALID_HANDLE_VALUE)
+        CloseHandle(this->file);
+    this->mapping = nullptr;
+    this->file = INVALID_HANDLE_VALUE;
+#else
+    if (this->Data != nullptr)
+        munmap(const_cast<unsigned char*>(this->Data), this->Size);
+#endif
+    this->Data = nullptr;
+    this->Size = 0;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+#include <string>
+
+#include <GL/glew.h>
+
+
+// A file mapped read-only into memory. The pages are served from
+// the OS page cache, so every process mapping the same file shares
+// them. Mappings can't be copied.
+class MappedFile
+{
+public:
+    // State
+    const unsigned char *Data; // Start of the mapping (nullptr if nothing is mapped)
+    GLsizeiptr           Size;
+    // Constructor/Destructor (the destructor unmaps the file)
+    MappedFile();
+    ~MappedFile();
+    // Maps the whole file, hinting the OS to read it ahead sequentially; returns false if it can't be opened
+    GLboolean Open(const std::string &path);
+    // Unmaps the file
+    void      Close();
+    // Granularity of mappings; the part of the last page beyond the end of a file reads as zeros
+    static GLsizeiptr PageSize();
+private:
+#ifdef _WIN32
+    void *file, *mapping; // Windows handles
+#endif
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+};
+
+#endif
\ No newline at end of file
@@ -8,7 +8,10 @@
 ******************************************************************/
 #include "particle_generator.hpp"
 
-ParticleGenerator::ParticleGenerator(Shader shader, Texture2D texture, GLuint amount)
+// Size of a rendered particle quad in pixels
+static const GLfloat PARTICLE_SCALE = 10.0f;
+
+ParticleGenerator::ParticleGenerator(Shader &shader, TextureView texture, GLuint amount)
     : shader(shader), texture(texture), amount(amount)
 {
     this->init();
@@ -36,51 +39,24 @@ void ParticleGenerator::Update(GLfloat dt, GameObject &object, GLuint newParticl
 }
 
 // Render all particles
-void ParticleGenerator::Draw()
+void ParticleGenerator::Draw(RenderQueue &queue)
 {
-    // Use additive blending to give it a 'glow' effect
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-    this->shader.Use();
-    for (Particle particle : this->particles)
+    // Use additive blending to give it a 'glow' effect; all particles end up in one instanced batch
+    SpriteInstance instance;
+    instance.Rotation = 0.0f;
+    for (const Particle &particle : this->particles)
     {
         if (particle.Life > 0.0f)
         {
-            this->shader.SetVector2f("offset", particle.Position);
-            this->shader.SetVector4f("color", particle.Color);
-            this->texture.Bind();
-            glBindVertexArray(this->VAO);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-            glBindVertexArray(0);
+            instance.Rect = glm::vec4(particle.Position, PARTICLE_SCALE, PARTICLE_SCALE);
+            instance.Color = particle.Color;
+            queue.Submit(LAYER_PARTICLES, BLEND_ADDITIVE, this->shader, this->texture, instance);
         }
     }
-    // Don't forget to reset to default blending mode
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
 void ParticleGenerator::init()
 {
-    // Set up mesh and attribute properties
-    GLuint VBO;
-    GLfloat particle_quad[] = {
-        0.0f, 1.0f, 0.0f, 1.0f,
-        1.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, 0.0f,
-
-        0.0f, 1.0f, 0.0f, 1.0f,
-        1.0f, 1.0f, 1.0f, 1.0f,
-        1.0f, 0.0f, 1.0f, 0.0f
-    }; 
-    glGenVertexArrays(1, &this->VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(this->VAO);
-    // Fill mesh buffer
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(particle_quad), particle_quad, GL_STATIC_DRAW);
-    // Set mesh attributes
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid*)0);
-    glBindVertexArray(0);
-
     // Create this->amount default particle instances
     for (GLuint i = 0; i < this->amount; ++i)
         this->particles.push_back(Particle());
@@ -134,6 +110,12 @@ void ParticleGenerator::UpdateAmount(GLuint amount)
 	this->amount = amount;
 }
 
+void ParticleGenerator::Shift(glm::vec2 offset)
+{
+    for (Particle &particle : this->particles)
+        particle.Position += offset;
+}
+
 void ParticleGenerator::Reset()
 {
 	particles.clear();
@@ -16,6 +16,7 @@
 #include "shader.hpp"
 #include "texture.hpp"
 #include "game_object.hpp"
+#include "render_queue.hpp"
 
 
 // Represents a single particle and its state
@@ -34,23 +35,24 @@ struct Particle {
 class ParticleGenerator
 {
 public:
-    // Constructor
-    ParticleGenerator(Shader shader, Texture2D texture, GLuint amount);
+    // Constructor (the shader and texture must outlive the generator)
+    ParticleGenerator(Shader &shader, TextureView texture, GLuint amount);
     // Update all particles
     void Update(GLfloat dt, GameObject &object, GLuint newParticles, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
-    // Render all particles
-    void Draw();
+    // Queue all live particles for rendering
+    void Draw(RenderQueue &queue);
 	void UpdateAmount(GLuint amount);
 	void Reset();
+    // Moves all particles by offset (e.g. when the world is rebased)
+    void Shift(glm::vec2 offset);
 private:
     // State
     std::vector<Particle> particles;
     GLuint amount;
     // Render state
-    Shader shader;
-    Texture2D texture;
-    GLuint VAO;
-    // Initializes buffer and vertex attributes
+    Shader &shader;
+    TextureView texture;
+    // Initializes the particle pool
     void init();
     // Returns the first Particle index that's currently unused e.g. Life <= 0.0f or 0 if no particle is currently inactive
     GLuint firstUnusedParticle();
@@ -8,97 +8,183 @@
 ******************************************************************/
 #include "post_processor.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <sstream>
 
-PostProcessor::PostProcessor(Shader shader, GLuint width, GLuint height) 
-    : PostProcessingShader(shader), Texture(), Width(width), Height(height), Confuse(GL_FALSE), Chaos(GL_FALSE), Shake(GL_FALSE)
+#include "gl_state.hpp"
+#include "gpu_timer.hpp"
+#include "resource_manager.hpp"
+
+PostProcessor::PostProcessor(GLuint width, GLuint height, GLuint samples) 
+    : PostProcessingShaders(), Texture(), Width(width), Height(height), Samples(samples), Scale(1.0f), Viewport(0, 0, width, height), Confuse(GL_FALSE), Chaos(GL_FALSE), Shake(GL_FALSE), uvScaleUniforms(), renderWidth(width), renderHeight(height), passThrough(GL_FALSE), allocated(GL_FALSE)
 {
-    // Initialize renderbuffer/framebuffer object
-    glGenFramebuffers(1, &this->MSFBO);
-    glGenFramebuffers(1, &this->FBO);
-    glGenRenderbuffers(1, &this->RBO);
-    
-    // Initialize renderbuffer storage with a multisampled color buffer (don't need a depth/stencil buffer)
-    glBindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
-    glBindRenderbuffer(GL_RENDERBUFFER, this->RBO);
-    glRenderbufferStorageMultisample(GL_RENDERBUFFER, 8, GL_RGB, width, height); // Allocate storage for render buffer object
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->RBO); // Attach MS render buffer object to framebuffer
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        std::cout << "ERROR::POSTPROCESSOR: Failed to initialize MSFBO" << std::endl;
-        
-    // Also initialize the FBO/texture to blit multisampled color-buffer to; used for shader operations (for postprocessing effects)
-    glBindFramebuffer(GL_FRAMEBUFFER, this->FBO);
-    this->Texture.Generate(width, height, NULL);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->Texture.ID, 0); // Attach texture to framebuffer as its color attachment
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        std::cout << "ERROR::POSTPROCESSOR: Failed to initialize FBO" << std::endl;
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // Initialize renderbuffer/framebuffer object (their storage is allocated once an effect is first used)
+    this->MSFBO = GenFramebuffer();
+    this->FBO = GenFramebuffer();
+    this->RBO = GenRenderbuffer();
     
-    // Initialize render data and uniforms
+    // Initialize render data and compile a specialised shader for each effect combination (all queued first, so they compile in parallel)
     this->initRenderData();
-    this->PostProcessingShader.SetInteger("scene", 0, GL_TRUE);
-    GLfloat offset = 1.0f / 300.0f;
-    GLfloat offsets[9][2] = {
-        { -offset,  offset  },  // top-left
-        {  0.0f,    offset  },  // top-center
-        {  offset,  offset  },  // top-right
-        { -offset,  0.0f    },  // center-left
-        {  0.0f,    0.0f    },  // center-center
-        {  offset,  0.0f    },  // center - right
-        { -offset, -offset  },  // bottom-left
-        {  0.0f,   -offset  },  // bottom-center
-        {  offset, -offset  }   // bottom-right    
-    };
-    glUniform2fv(glGetUniformLocation(this->PostProcessingShader.ID, "offsets"), 9, (GLfloat*)offsets);
-    GLint edge_kernel[9] = {
-        -1, -1, -1,
-        -1,  8, -1,
-        -1, -1, -1
-    };
-    glUniform1iv(glGetUniformLocation(this->PostProcessingShader.ID, "edge_kernel"), 9, edge_kernel);
-    GLfloat blur_kernel[9] = {
-        1.0 / 16, 2.0 / 16, 1.0 / 16,
-        2.0 / 16, 4.0 / 16, 2.0 / 16,
-        1.0 / 16, 2.0 / 16, 1.0 / 16
-    };
-    glUniform1fv(glGetUniformLocation(this->PostProcessingShader.ID, "blur_kernel"), 9, blur_kernel);    
+    for (GLuint effects = 0; effects < POSTPROCESSING_PERMUTATIONS; ++effects)
+    {
+        if ((effects & POSTPROCESSING_CHAOS) && (effects & POSTPROCESSING_CONFUSE))
+            continue; // Chaos takes precedence over confuse; see permutation()
+        std::string defines;
+        if (effects & POSTPROCESSING_CHAOS)
+            defines += "#define CHAOS\n";
+        if (effects & POSTPROCESSING_CONFUSE)
+            defines += "#define CONFUSE\n";
+        if (effects & POSTPROCESSING_SHAKE)
+            defines += "#define SHAKE\n";
+        std::stringstream name; name << "postprocessing_" << effects;
+        ResourceManager::QueueShader("shaders/post_processing.vert", "shaders/post_processing.frag", nullptr, name.str(), defines.c_str());
+    }
+    for (GLuint effects = 0; effects < POSTPROCESSING_PERMUTATIONS; ++effects)
+    {
+        if ((effects & POSTPROCESSING_CHAOS) && (effects & POSTPROCESSING_CONFUSE))
+            continue;
+        std::stringstream name; name << "postprocessing_" << effects;
+        this->PostProcessingShaders[effects] = &ResourceManager::GetShader(name.str());
+        this->PostProcessingShaders[effects]->SetInteger("scene", 0, GL_TRUE);
+        this->uvScaleUniforms[effects] = this->PostProcessingShaders[effects]->Uniform("uvScale");
+    }
+}
+
+GLboolean PostProcessor::Active() const
+{
+    return this->effectsEnabled() || this->Scale < 1.0f;
+}
+
+void PostProcessor::Resize(GLint x, GLint y, GLuint width, GLuint height)
+{
+    this->Viewport = glm::ivec4(x, y, width, height);
+    if (width == this->Width && height == this->Height)
+        return;
+    this->Width = width;
+    this->Height = height;
+    this->allocated = GL_FALSE; // Reallocated on next use
+}
+
+void PostProcessor::SetSamples(GLuint samples)
+{
+    if (samples == this->Samples)
+        return;
+    this->Samples = samples;
+    this->allocated = GL_FALSE; // Reallocated on next use
 }
 
 void PostProcessor::BeginRender()
 {
-    glBindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
+    // Without active effects the scene goes straight to the backbuffer; no offscreen targets are touched
+    this->passThrough = !this->Active();
+    if (this->passThrough)
+    {
+        GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(this->Viewport.x, this->Viewport.y, this->Viewport.z, this->Viewport.w);
+    }
+    else
+    {
+        if (!this->allocated)
+            this->allocateTargets();
+        // Render into the lower-left part of the targets that the current scale covers
+        this->renderWidth = std::max(1, static_cast<GLint>(this->Width * this->Scale + 0.5f));
+        this->renderHeight = std::max(1, static_cast<GLint>(this->Height * this->Scale + 0.5f));
+        GLState::BindFramebuffer(GL_FRAMEBUFFER, this->Samples > 1 ? this->MSFBO.ID : this->FBO.ID);
+        glViewport(0, 0, this->renderWidth, this->renderHeight);
+    }
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 }
 void PostProcessor::EndRender()
 {
+    if (this->passThrough)
+        return;
     // Now resolve multisampled color-buffer into intermediate FBO to store to texture
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, this->MSFBO);
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->FBO);
-    glBlitFramebuffer(0, 0, this->Width, this->Height, 0, 0, this->Width, this->Height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0); // Binds both READ and WRITE framebuffer to default framebuffer
+    if (this->Samples > 1)
+    {
+        GpuTimer::Begin("resolve");
+        GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, this->MSFBO.ID);
+        GLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, this->FBO.ID);
+        glBlitFramebuffer(0, 0, this->renderWidth, this->renderHeight, 0, 0, this->renderWidth, this->renderHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        GpuTimer::End("resolve");
+    }
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0); // Binds both READ and WRITE framebuffer to default framebuffer
 }
 
-void PostProcessor::Render(GLfloat time)
+void PostProcessor::Render()
 {
-    // Set uniforms/options
-    this->PostProcessingShader.Use();
-    this->PostProcessingShader.SetFloat("time", time);
-    this->PostProcessingShader.SetInteger("confuse", this->Confuse);
-    this->PostProcessingShader.SetInteger("chaos", this->Chaos);
-    this->PostProcessingShader.SetInteger("shake", this->Shake);
-    // Render textured quad
-    glActiveTexture(GL_TEXTURE0);
+    if (this->passThrough)
+        return; // Scene is already on the backbuffer
+    // Select the permutation that contains exactly the enabled effects (time is read from the per-frame uniform block)
+    GLuint effects = this->permutation();
+    this->PostProcessingShaders[effects]->Use();
+    this->PostProcessingShaders[effects]->SetVector2f(this->uvScaleUniforms[effects],
+        glm::vec2(static_cast<GLfloat>(this->renderWidth) / this->Width, static_cast<GLfloat>(this->renderHeight) / this->Height));
+    // Clear the letterbox bars and upscale the scene into the viewport
+    GpuTimer::Begin("post");
+    glClear(GL_COLOR_BUFFER_BIT);
+    glViewport(this->Viewport.x, this->Viewport.y, this->Viewport.z, this->Viewport.w);
+    GLState::ActiveTexture(GL_TEXTURE0);
     this->Texture.Bind();	
-    glBindVertexArray(this->VAO);
+    GLState::BindVertexArray(this->VAO.ID);
     glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
+    GpuTimer::End("post");
+}
+
+GLboolean PostProcessor::effectsEnabled() const
+{
+    return this->Confuse || this->Chaos || this->Shake;
+}
+
+GLuint PostProcessor::permutation() const
+{
+    GLuint effects = 0;
+    if (this->Chaos)
+        effects |= POSTPROCESSING_CHAOS;
+    else if (this->Confuse)
+        effects |= POSTPROCESSING_CONFUSE;
+    if (this->Shake)
+        effects |= POSTPROCESSING_SHAKE;
+    return effects;
+}
+
+void PostProcessor::allocateTargets()
+{
+    // Multisampled color buffer (don't need a depth/stencil buffer); skipped entirely when multisampling is off
+    if (this->Samples > 1)
+    {
+        GLint maxSamples;
+        glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+        if (this->Samples > static_cast<GLuint>(maxSamples))
+            this->Samples = maxSamples;
+        GLState::BindFramebuffer(GL_FRAMEBUFFER, this->MSFBO.ID);
+        glBindRenderbuffer(GL_RENDERBUFFER, this->RBO.ID);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, this->Samples, GL_RGB, this->Width, this->Height); // Allocate storage for render buffer object
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->RBO.ID); // Attach MS render buffer object to framebuffer
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            std::cout << "ERROR::POSTPROCESSOR: Failed to initialize MSFBO" << std::endl;
+    }
+    else
+    {
+        // Release the multisampled storage
+        glBindRenderbuffer(GL_RENDERBUFFER, this->RBO.ID);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGB, 0, 0);
+    }
+
+    // Also initialize the FBO/texture to blit multisampled color-buffer to (or render to directly); used for shader operations (for postprocessing effects)
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, this->FBO.ID);
+    this->Texture.Generate(this->Width, this->Height, NULL);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->Texture.ID, 0); // Attach texture to framebuffer as its color attachment
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::POSTPROCESSOR: Failed to initialize FBO" << std::endl;
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+    this->allocated = GL_TRUE;
 }
 
 void PostProcessor::initRenderData()
 {
     // Configure VAO/VBO
-    GLuint VBO;
     GLfloat vertices[] = {
         // Pos        // Tex
         -1.0f, -1.0f, 0.0f, 0.0f,
@@ -109,15 +195,13 @@ void PostProcessor::initRenderData()
          1.0f, -1.0f, 1.0f, 0.0f,
          1.0f,  1.0f, 1.0f, 1.0f
     };
-    glGenVertexArrays(1, &this->VAO);
-    glGenBuffers(1, &VBO);
+    this->VAO = GenVertexArray();
+    this->VBO = GenBuffer();
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->VBO.ID);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindVertexArray(this->VAO);
+    GLState::BindVertexArray(this->VAO.ID);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GL_FLOAT), (GLvoid*)0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
 }
\ No newline at end of file
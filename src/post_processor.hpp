@@ -15,36 +15,73 @@
 #include "texture.hpp"
 #include "sprite_renderer.hpp"
 #include "shader.hpp"
+#include "gl_object.hpp"
+
+
+// Effect bits selecting a post-processing shader permutation
+enum PostProcessingEffect {
+	POSTPROCESSING_CHAOS   = 1,
+	POSTPROCESSING_CONFUSE = 2,
+	POSTPROCESSING_SHAKE   = 4
+};
+// Number of effect combinations
+const GLuint POSTPROCESSING_PERMUTATIONS = 8;
 
 
 // PostProcessor hosts all PostProcessing effects for the Breakout
 // Game. It renders the game on a textured quad after which one can
 // enable specific effects by enabling either the Confuse, Chaos or 
-// Shake boolean. 
+// Shake boolean. Every effect combination has its own shader
+// permutation, compiled with only the code that combination needs.
+// The scene can be rendered at a fraction (Scale) of the offscreen
+// targets' size; the post-processing pass then upscales it into the
+// (letterboxed) Viewport of the default framebuffer. When no effect
+// is enabled and the scale is 1 the game is rendered straight to the
+// backbuffer and no offscreen pass takes place.
 // It is required to call BeginRender() before rendering the game
 // and EndRender() after rendering the game for the class to work.
 class PostProcessor
 {
 public:
 	// State
-	Shader PostProcessingShader;
+	Shader *PostProcessingShaders[POSTPROCESSING_PERMUTATIONS]; // Indexed by a combination of PostProcessingEffect bits (stored by the ResourceManager)
 	Texture2D Texture;
-	GLuint Width, Height;
+	GLuint Width, Height; // Size of the offscreen targets (that of the viewport)
+	GLuint Samples; // Samples of the offscreen color buffer (0 or 1 disables multisampling)
+	GLfloat Scale; // Fraction of Width/Height the scene is rendered at (dynamic resolution)
+	glm::ivec4 Viewport; // Region of the default framebuffer the scene is presented in: <x, y, width, height>
 	// Options
 	GLboolean Confuse, Chaos, Shake;
 	// Constructor
-	PostProcessor(Shader shader, GLuint width, GLuint height);
+	PostProcessor(GLuint width, GLuint height, GLuint samples = 8);
+	// Whether any effect is enabled or the scene is downscaled (and thus the offscreen pass is needed)
+	GLboolean Active() const;
+	// Moves the presentation viewport and resizes the offscreen targets to match it (reallocated the next time they are used)
+	void Resize(GLint x, GLint y, GLuint width, GLuint height);
+	// Changes the number of samples of the offscreen targets (reallocated the next time an effect is used)
+	void SetSamples(GLuint samples);
 	// Prepares the postprocessor's framebuffer operations before rendering the game
 	void BeginRender();
 	// Should be called after rendering the game, so it stores all the rendered data into a texture object
 	void EndRender();
 	// Renders the PostProcessor texture quad (as a screen-encompassing large sprite)
-	void Render(GLfloat time);
+	void Render();
 private:
 	// Render state
-	GLuint MSFBO, FBO; // MSFBO = Multisampled FBO. FBO is regular, used for blitting MS color-buffer to texture
-	GLuint RBO; // RBO is used for multisampled color buffer
-	GLuint VAO;
+	FramebufferObject MSFBO, FBO; // MSFBO = Multisampled FBO. FBO is regular, used for blitting MS color-buffer to texture
+	RenderbufferObject RBO; // RBO is used for multisampled color buffer
+	VertexArrayObject VAO;
+	BufferObject VBO;
+	GLint uvScaleUniforms[POSTPROCESSING_PERMUTATIONS]; // Handle of each permutation's uvScale uniform
+	GLuint renderWidth, renderHeight; // Size the scene is rendered at this frame
+	GLboolean passThrough; // Whether the current frame bypasses the offscreen targets
+	GLboolean allocated;   // Whether the offscreen targets have storage matching Width/Height/Samples
+	// Returns whether any effect is enabled
+	GLboolean effectsEnabled() const;
+	// Returns the permutation matching the enabled effects
+	GLuint permutation() const;
+	// (Re)allocates the storage of the offscreen targets
+	void allocateTargets();
 	// Initialize quad for rendering postprocessing texture
 	void initRenderData();
 };
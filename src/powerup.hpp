@@ -34,9 +34,9 @@ public:
 	GLfloat     Duration;
 	GLboolean   Activated;
 	// Constructor
-	PowerUp(std::string type, glm::vec3 color, GLfloat duration, glm::vec2 position, Texture2D texture)
+	PowerUp(std::string type, glm::vec3 color, GLfloat duration, glm::vec2 position, TextureView texture)
 		: GameObject(position, SIZE, texture, color, VELOCITY), Type(type), Duration(duration), Activated() { }
-	PowerUp(std::string type, glm::vec3 color, GLfloat duration, glm::vec2 position, Texture2D texture, glm::vec2 velocity)
+	PowerUp(std::string type, glm::vec3 color, GLfloat duration, glm::vec2 position, TextureView texture, glm::vec2 velocity)
 		: GameObject(position, SIZE, texture, color, velocity), Type(type), Duration(duration), Activated() { }
 };
 
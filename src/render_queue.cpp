@@ -0,0 +1,98 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "render_queue.hpp"
+#include "gl_state.hpp"
+#include "gpu_timer.hpp"
+
+#include <algorithm>
+
+// Sort key layout: | layer:8 | blend:4 | shader:16 | texture:16 | sequence:20 |
+static const GLuint   SEQUENCE_BITS = 20;
+static const GLuint64 SEQUENCE_MASK = (1ull << SEQUENCE_BITS) - 1;
+
+static GLuint64 MakeKey(RenderLayer layer, BlendMode blend, GLuint program, GLuint texture, GLuint sequence)
+{
+    return (static_cast<GLuint64>(layer) & 0xFF) << 56
+        | (static_cast<GLuint64>(blend) & 0xF) << 52
+        | (static_cast<GLuint64>(program) & 0xFFFF) << 36
+        | (static_cast<GLuint64>(texture) & 0xFFFF) << 20
+        | (sequence & SEQUENCE_MASK);
+}
+
+
+RenderQueue::RenderQueue(SpriteRenderer &renderer, Shader &spriteShader)
+    : Commands(0), Batches(0), renderer(renderer), spriteShader(spriteShader)
+{
+
+}
+
+void RenderQueue::Submit(RenderLayer layer, BlendMode blend, const Shader &shader, TextureView texture, const SpriteInstance &instance)
+{
+    RenderCommand command;
+    command.Key = MakeKey(layer, blend, shader.ID, texture.ID, this->commands.size());
+    command.Program = shader.ID;
+    command.Texture = texture.ID;
+    command.Instance = this->instances.size();
+    this->commands.push_back(command);
+    this->instances.push_back(instance);
+}
+
+void RenderQueue::SubmitSprite(RenderLayer layer, TextureView texture, glm::vec2 position, glm::vec2 size, GLfloat rotate, glm::vec3 color)
+{
+    SpriteInstance instance;
+    instance.Rect = glm::vec4(position, size);
+    instance.Color = glm::vec4(color, 1.0f);
+    instance.Rotation = rotate;
+    this->Submit(layer, BLEND_ALPHA, this->spriteShader, texture, instance);
+}
+
+void RenderQueue::Flush()
+{
+    this->Commands = this->commands.size();
+    this->Batches = 0;
+    std::sort(this->commands.begin(), this->commands.end(),
+        [](const RenderCommand &a, const RenderCommand &b) { return a.Key < b.Key; }
+    );
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLboolean timingParticles = GL_FALSE; // Particle batches are contiguous (layer sorts first), so they form a single timed pass
+    for (std::vector<RenderCommand>::size_type i = 0; i < this->commands.size();)
+    {
+        // Gather all following commands that share this command's render state
+        const RenderCommand &first = this->commands[i];
+        GLuint64 state = first.Key >> SEQUENCE_BITS;
+        this->batch.clear();
+        // (IDs are truncated in the key, so compare the full names as well)
+        for (; i < this->commands.size() && (this->commands[i].Key >> SEQUENCE_BITS) == state
+            && this->commands[i].Program == first.Program && this->commands[i].Texture == first.Texture; ++i)
+            this->batch.push_back(this->instances[this->commands[i].Instance]);
+        RenderLayer layer = static_cast<RenderLayer>((state >> (56 - SEQUENCE_BITS)) & 0xFF);
+        if ((layer == LAYER_PARTICLES) != timingParticles)
+        {
+            if (timingParticles)
+                GpuTimer::End("particles");
+            else
+                GpuTimer::Begin("particles");
+            timingParticles = !timingParticles;
+        }
+        // Apply its state (redundant changes are elided by GLState) and draw the batch
+        BlendMode blend = static_cast<BlendMode>((state >> (52 - SEQUENCE_BITS)) & 0xF);
+        if (blend == BLEND_ADDITIVE)
+            GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE);
+        else
+            GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLState::UseProgram(first.Program);
+        GLState::BindTexture(GL_TEXTURE_2D, first.Texture);
+        this->renderer.DrawInstances(this->batch.data(), this->batch.size());
+        ++this->Batches;
+    }
+    if (timingParticles)
+        GpuTimer::End("particles");
+    this->commands.clear();
+    this->instances.clear();
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "shader.hpp"
+#include "texture.hpp"
+#include "sprite_renderer.hpp"
+
+
+// Draw layers of the scene, rendered back to front
+enum RenderLayer {
+    LAYER_BACKGROUND,
+    LAYER_LEVEL,
+    LAYER_PLAYER,
+    LAYER_POWERUPS,
+    LAYER_PARTICLES,
+    LAYER_BALLS
+};
+
+// Blend modes a command can be rendered with
+enum BlendMode {
+    BLEND_ALPHA,   // Regular alpha blending
+    BLEND_ADDITIVE // Additive blending, gives particles a 'glow' effect
+};
+
+// A single queued quad. The sort key packs (from most to least
+// significant bits) layer, blend mode, shader, texture and the
+// submission sequence number, so sorting by key yields layer order
+// with state changes minimized and submission order preserved.
+struct RenderCommand {
+    GLuint64 Key;
+    GLuint   Program;
+    GLuint   Texture;
+    GLuint   Instance; // Index into the queue's instance storage
+};
+
+
+// RenderQueue collects the draw commands of all systems during a
+// frame. Flush() sorts them by key, merges adjacent commands that
+// share layer, blend mode, shader and texture into a single
+// instanced draw call and executes the resulting batches.
+class RenderQueue
+{
+public:
+    // Statistics of the last flush
+    GLuint Commands, Batches;
+    // Constructor (sprites submitted through SubmitSprite are drawn with the given shader)
+    RenderQueue(SpriteRenderer &renderer, Shader &spriteShader);
+    // Queues a quad drawn with the given shader and texture
+    void Submit(RenderLayer layer, BlendMode blend, const Shader &shader, TextureView texture, const SpriteInstance &instance);
+    // Queues an alpha blended sprite drawn with the sprite shader
+    void SubmitSprite(RenderLayer layer, TextureView texture, glm::vec2 position, glm::vec2 size, GLfloat rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f));
+    // Sorts, batches and renders all queued commands, then empties the queue
+    void Flush();
+private:
+    // Render state
+    SpriteRenderer              &renderer;
+    Shader                      &spriteShader;
+    // Queued data
+    std::vector<RenderCommand>  commands;
+    std::vector<SpriteInstance> instances;
+    std::vector<SpriteInstance> batch; // Instances of the batch being assembled
+};
+
+#endif
\ No newline at end of file
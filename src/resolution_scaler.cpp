@@ -0,0 +1,43 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "resolution_scaler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+ResolutionScaler::ResolutionScaler(GLfloat budget)
+    : Scale(1.0f), Budget(budget), settle(0)
+{
+
+}
+
+GLfloat ResolutionScaler::Update(GLfloat gpuMilliseconds)
+{
+    if (this->settle > 0)
+    {
+        --this->settle;
+        return this->Scale;
+    }
+    if (gpuMilliseconds <= 0.0f)
+        return this->Scale; // No timing available
+
+    GLfloat scale = this->Scale;
+    if (gpuMilliseconds > this->Budget)
+        scale *= std::sqrt(this->Budget / gpuMilliseconds);
+    else if (gpuMilliseconds < this->Budget * RESOLUTION_HEADROOM)
+        scale += RESOLUTION_STEP;
+    scale = std::min(1.0f, std::max(RESOLUTION_MIN_SCALE, scale));
+    if (scale != this->Scale)
+    {
+        this->Scale = scale;
+        this->settle = RESOLUTION_SETTLE_FRAMES;
+    }
+    return this->Scale;
+}
\ No newline at end of file
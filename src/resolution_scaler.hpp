@@ -0,0 +1,44 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef RESOLUTION_SCALER_H
+#define RESOLUTION_SCALER_H
+
+#include <GL/glew.h>
+
+
+// Lowest render scale the scaler goes down to
+const GLfloat RESOLUTION_MIN_SCALE = 0.5f;
+// Scale increment when there is headroom in the budget
+const GLfloat RESOLUTION_STEP = 0.05f;
+// Fraction of the budget GPU time must stay below before the scale is raised again
+const GLfloat RESOLUTION_HEADROOM = 0.75f;
+// Frames to wait after a change before measuring again (GPU timings lag a few frames behind)
+const GLuint  RESOLUTION_SETTLE_FRAMES = 6;
+
+// ResolutionScaler picks the scale the scene is rendered at so
+// that GPU frame time stays within a budget. Over budget, the scale
+// drops in proportion to the overshoot (cost scales with the pixel
+// count, i.e. with the square of the scale); with enough headroom it
+// creeps back up in small steps. After every change it waits for
+// the timings to reflect the new scale before acting again.
+class ResolutionScaler
+{
+public:
+    // State
+    GLfloat Scale;  // Current render scale in [RESOLUTION_MIN_SCALE, 1]
+    GLfloat Budget; // Target GPU frame time in milliseconds
+    // Constructor
+    ResolutionScaler(GLfloat budget);
+    // Feeds the latest GPU frame time (in milliseconds, 0 if unknown) and returns the scale to render the next frame at
+    GLfloat Update(GLfloat gpuMilliseconds);
+private:
+    GLuint settle; // Frames left before the next adjustment
+};
+
+#endif
\ No newline at end of file
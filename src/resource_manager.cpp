@@ -8,108 +8,570 @@
 ******************************************************************/
 #include "resource_manager.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <fstream>
+#include <utility>
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#define MAKE_DIRECTORY(path) _mkdir(path)
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#define MAKE_DIRECTORY(path) mkdir(path, 0755)
+#endif
 
 #include <SOIL.h>
 
+#include "gl_state.hpp"
+#include "hash.hpp"
+#include "embedded_assets.hpp"
+#include "texture_format.hpp"
+
 // Instantiate static variables
-std::map<std::string, Texture2D>    ResourceManager::Textures;
-std::map<std::string, Shader>       ResourceManager::Shaders;
+std::deque<Shader>                  ResourceManager::shaders;
+std::vector<Texture2D>              ResourceManager::textures;
+std::map<std::string, GLuint>       ResourceManager::shaderNames;
+std::map<std::string, GLuint>       ResourceManager::textureNames;
+std::map<GLuint, std::string>       ResourceManager::pendingShaders;
+std::vector<TextureRecord>          ResourceManager::textureRecords;
+GLsizeiptr                          ResourceManager::textureBudget = DEFAULT_TEXTURE_BUDGET;
+GLsizeiptr                          ResourceManager::textureMemory = 0;
+GLuint64                            ResourceManager::textureRetrievals = 0;
+std::vector<AssetPack *>            ResourceManager::packs;
 
 
-Shader ResourceManager::LoadShader(const GLchar *vShaderFile, const GLchar *fShaderFile, const GLchar *gShaderFile, std::string name)
+Shader &ResourceManager::LoadShader(const GLchar *vShaderFile, const GLchar *fShaderFile, const GLchar *gShaderFile, std::string name, const GLchar *defines)
 {
-    Shaders[name] = loadShaderFromFile(vShaderFile, fShaderFile, gShaderFile);
-    return Shaders[name];
+    QueueShader(vShaderFile, fShaderFile, gShaderFile, name, defines);
+    return GetShader(name);
 }
 
-Shader ResourceManager::GetShader(std::string name)
+void ResourceManager::QueueShader(const GLchar *vShaderFile, const GLchar *fShaderFile, const GLchar *gShaderFile, std::string name, const GLchar *defines)
 {
-    return Shaders[name];
+    // Let the driver compile on as many threads as it likes (ARB_parallel_shader_compile; same entry point as the KHR extension)
+    static GLboolean threadsConfigured = GL_FALSE;
+    if (!threadsConfigured)
+    {
+        if (GLEW_ARB_parallel_shader_compile)
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        threadsConfigured = GL_TRUE;
+    }
+
+    GLboolean compiling;
+    std::string cachePath;
+    ShaderHandle handle = FindShader(name);
+    shaders[handle.Index] = loadShaderFromFile(vShaderFile, fShaderFile, gShaderFile, defines, compiling, cachePath);
+    if (compiling)
+        pendingShaders[handle.Index] = cachePath;
 }
 
-Texture2D ResourceManager::LoadTexture(const GLchar *file, GLboolean alpha, std::string name)
+Shader &ResourceManager::GetShader(std::string name)
 {
-    Textures[name] = loadTextureFromFile(file, alpha);
-    return Textures[name];
+    return GetShader(FindShader(name));
 }
 
-Texture2D ResourceManager::GetTexture(std::string name)
+Shader &ResourceManager::GetShader(ShaderHandle handle)
 {
-    return Textures[name];
+    std::map<GLuint, std::string>::iterator pending = pendingShaders.find(handle.Index);
+    if (pending != pendingShaders.end())
+    {
+        // Complete the compile and store the linked program, so later runs skip compiling it
+        Shader &shader = shaders[handle.Index];
+        GLenum format;
+        std::vector<char> binary;
+        if (shader.FinishCompile() && !pending->second.empty() && shader.GetBinary(format, binary))
+        {
+            MAKE_DIRECTORY("cache");
+            MAKE_DIRECTORY(SHADER_CACHE_DIRECTORY);
+            GLuint header = format;
+            if (!writeCacheFile(pending->second, &header, sizeof(header), binary.data(), binary.size()))
+                std::cout << "ERROR::SHADER: Failed to write program binary " << pending->second << std::endl;
+        }
+        pendingShaders.erase(pending);
+    }
+    return shaders[handle.Index];
 }
 
-void ResourceManager::Clear()
+ShaderHandle ResourceManager::FindShader(const std::string &name)
 {
-    // (Properly) delete all shaders	
-    for (auto iter : Shaders)
-        glDeleteProgram(iter.second.ID);
-    // (Properly) delete all textures
-    for (auto iter : Textures)
-        glDeleteTextures(1, &iter.second.ID);
-}
-
-Shader ResourceManager::loadShaderFromFile(const GLchar *vShaderFile, const GLchar *fShaderFile, const GLchar *gShaderFile)
-{
-    // 1. Retrieve the vertex/fragment source code from filePath
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::string geometryCode;
-    try
-    {
-        // Open files
-        std::ifstream vertexShaderFile(vShaderFile);
-        std::ifstream fragmentShaderFile(fShaderFile);
-        std::stringstream vShaderStream, fShaderStream;
-        // Read file's buffer contents into streams
-        vShaderStream << vertexShaderFile.rdbuf();
-        fShaderStream << fragmentShaderFile.rdbuf();
-        // close file handlers
-        vertexShaderFile.close();
-        fragmentShaderFile.close();
-        // Convert stream into string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-        // If geometry shader path is present, also load a geometry shader
-        if (gShaderFile != nullptr)
+    std::map<std::string, GLuint>::iterator found = shaderNames.find(name);
+    if (found != shaderNames.end())
+        return ShaderHandle(found->second);
+    // Unknown names get an (empty) slot, filled once the shader is loaded
+    shaders.emplace_back();
+    shaderNames[name] = shaders.size() - 1;
+    return ShaderHandle(shaders.size() - 1);
+}
+
+const Texture2D &ResourceManager::LoadTexture(const GLchar *file, GLboolean alpha, std::string name)
+{
+    TextureHandle handle = FindTexture(name);
+    storeTexture(handle.Index, loadTextureFromFile(file, alpha), file, alpha);
+    return textures[handle.Index];
+}
+
+const Texture2D &ResourceManager::LoadTexture(const DecodedImage &image, std::string name)
+{
+    TextureHandle handle = FindTexture(name);
+    storeTexture(handle.Index, createTexture(image), image.File, image.Alpha);
+    return textures[handle.Index];
+}
+
+GLboolean ResourceManager::DecodeImage(const GLchar *file, GLboolean alpha, DecodedImage &image)
+{
+    image.File = file;
+    // A compressed texture next to the image is used as is, without reading the image at all
+    if (readCompressedTexture(file, alpha, image))
+        return GL_TRUE;
+    AssetView asset;
+    if (!ReadAsset(file, asset))
+    {
+        std::cout << "ERROR::TEXTURE: Failed to read " << file << std::endl;
+        return GL_FALSE;
+    }
+    // Look for the pixels in the texture cache, keyed by the file's contents (so an edited file is decoded again)
+    GLuint64 key = Fnv1a(asset.Data, asset.Size);
+    key = Fnv1a(&alpha, sizeof(alpha), key);
+    std::stringstream cachePath;
+    cachePath << TEXTURE_CACHE_DIRECTORY << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".tex";
+    if (readTextureCache(cachePath.str(), alpha, image))
+        return GL_TRUE;
+    int width, height;
+    unsigned char* pixels = SOIL_load_image_from_memory(asset.Data, static_cast<int>(asset.Size), &width, &height, 0, alpha ? SOIL_LOAD_RGBA : SOIL_LOAD_RGB);
+    if (pixels == nullptr)
+    {
+        std::cout << "ERROR::TEXTURE: Failed to decode " << file << std::endl;
+        return GL_FALSE;
+    }
+    image.Width = width;
+    image.Height = height;
+    image.Alpha = alpha;
+    image.Pixels.assign(pixels, pixels + width * height * (alpha ? 4 : 3));
+    SOIL_free_image_data(pixels);
+    writeTextureCache(cachePath.str(), image);
+    return GL_TRUE;
+}
+
+const Texture2D &ResourceManager::GetTexture(std::string name)
+{
+    return GetTexture(FindTexture(name));
+}
+
+const Texture2D &ResourceManager::GetTexture(TextureHandle handle)
+{
+    TextureRecord &record = textureRecords[handle.Index];
+    record.LastUse = ++textureRetrievals;
+    if (!record.Resident && !record.File.empty())
+    {
+        // Evicted: load it again (synchronously, as the caller needs it now)
+        std::string file = record.File;
+        storeTexture(handle.Index, loadTextureFromFile(file.c_str(), record.Alpha), file, record.Alpha);
+    }
+    return textures[handle.Index];
+}
+
+TextureHandle ResourceManager::FindTexture(const std::string &name)
+{
+    std::map<std::string, GLuint>::iterator found = textureNames.find(name);
+    if (found != textureNames.end())
+        return TextureHandle(found->second);
+    // Unknown names get an (empty) slot, filled once the texture is loaded
+    textures.emplace_back();
+    textureRecords.push_back(TextureRecord());
+    textureNames[name] = textures.size() - 1;
+    return TextureHandle(textures.size() - 1);
+}
+
+void ResourceManager::AcquireTexture(TextureHandle handle)
+{
+    ++textureRecords[handle.Index].References;
+}
+
+void ResourceManager::ReleaseTexture(TextureHandle handle)
+{
+    if (textureRecords[handle.Index].References > 0 && --textureRecords[handle.Index].References == 0)
+        evictTextures(textures.size());
+}
+
+void ResourceManager::SetTextureBudget(GLsizeiptr bytes)
+{
+    textureBudget = bytes;
+    evictTextures(textures.size());
+}
+
+GLsizeiptr ResourceManager::TextureMemory()
+{
+    return textureMemory;
+}
+
+GLboolean ResourceManager::ReadAsset(const std::string &path, AssetView &asset)
+{
+    // Files in the override directory win, so assets can be edited without rebuilding
+    std::string file = path;
+    static const char *overrideDirectory = std::getenv(ASSET_DIRECTORY_VARIABLE);
+    GLboolean overridden = GL_FALSE;
+    if (overrideDirectory != nullptr)
+    {
+        std::string candidate = std::string(overrideDirectory) + "/" + path;
+        if (std::ifstream(candidate.c_str()))
         {
-            std::ifstream geometryShaderFile(gShaderFile);
-            std::stringstream gShaderStream;
-            gShaderStream << geometryShaderFile.rdbuf();
-            geometryShaderFile.close();
-            geometryCode = gShaderStream.str();
+            file = candidate;
+            overridden = GL_TRUE;
         }
     }
-    catch (std::exception e)
+    if (!overridden)
     {
-        std::cout << "ERROR::SHADER: Failed to read shader files" << std::endl;
+        // Then the packs and the copies compiled into the executable, all viewed in place
+        for (const AssetPack *pack : packs)
+            if (pack->Read(path, asset))
+                return GL_TRUE;
+        const EmbeddedAsset *embedded = EmbeddedAssets::Find(path);
+        if (embedded != nullptr)
+        {
+            asset.Data = embedded->Data;
+            asset.Size = embedded->Size;
+            asset.Storage.clear();
+            return GL_TRUE;
+        }
+    }
+    // Large files are mapped rather than copied, unless they end on a page boundary (their terminating zero wouldn't be mapped)
+    std::ifstream stream(file.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+    if (!stream)
+        return GL_FALSE;
+    GLsizeiptr size = static_cast<GLsizeiptr>(stream.tellg());
+    if (size >= ASSET_MAP_THRESHOLD && size % MappedFile::PageSize() != 0)
+    {
+        std::shared_ptr<MappedFile> mapping = std::make_shared<MappedFile>();
+        if (mapping->Open(file))
+        {
+            asset.Data = mapping->Data;
+            asset.Size = mapping->Size;
+            asset.Storage.clear();
+            asset.Mapping = mapping;
+            return GL_TRUE;
+        }
+    }
+    stream.seekg(0);
+    asset.Storage.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    asset.Size = asset.Storage.size();
+    asset.Storage.push_back(0);
+    asset.Data = asset.Storage.data();
+    return GL_TRUE;
+}
+
+void ResourceManager::ListAssets(const std::string &directory, std::vector<std::string> &paths)
+{
+    std::string prefix = directory + "/";
+    std::vector<std::string> names;
+    // Loose files, including those of the override directory
+    static const char *overrideDirectory = std::getenv(ASSET_DIRECTORY_VARIABLE);
+    if (overrideDirectory != nullptr)
+        listFiles(std::string(overrideDirectory) + "/" + directory, names);
+    listFiles(directory, names);
+    for (const std::string &name : names)
+        paths.push_back(prefix + name);
+    // Pack entries and embedded assets right within the directory (not in subdirectories)
+    for (const AssetPack *pack : packs)
+        for (GLuint i = 0; i < pack->Count(); ++i)
+            if (std::strncmp(pack->Path(i), prefix.c_str(), prefix.size()) == 0 && std::strchr(pack->Path(i) + prefix.size(), '/') == nullptr)
+                paths.push_back(pack->Path(i));
+    for (const EmbeddedAsset *asset = EmbeddedAssets::Table; asset->Path != nullptr; ++asset)
+        if (std::strncmp(asset->Path, prefix.c_str(), prefix.size()) == 0 && std::strchr(asset->Path + prefix.size(), '/') == nullptr)
+            paths.push_back(asset->Path);
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+}
+
+GLboolean ResourceManager::MountPack(const std::string &path)
+{
+    AssetPack *pack = new AssetPack();
+    if (!pack->Open(path))
+    {
+        delete pack;
+        return GL_FALSE;
     }
-    const GLchar *vShaderCode = vertexCode.c_str();
-    const GLchar *fShaderCode = fragmentCode.c_str();
-    const GLchar *gShaderCode = geometryCode.c_str();
-    // 2. Now create shader object from source code
+    packs.insert(packs.begin(), pack);
+    return GL_TRUE;
+}
+
+void ResourceManager::Clear()
+{
+    // (Properly) delete all shaders and textures; their holders are gone by now, so nothing owning a GL object outlives the context
+    shaders.clear();
+    shaderNames.clear();
+    pendingShaders.clear();
+    textures.clear();
+    textureNames.clear();
+    textureRecords.clear();
+    textureMemory = 0;
+}
+
+Shader ResourceManager::loadShaderFromFile(const GLchar *vShaderFile, const GLchar *fShaderFile, const GLchar *gShaderFile, const GLchar *defines, GLboolean &compiling, std::string &cachePath)
+{
+    // 1. Retrieve the vertex/fragment source code (used in place; views are zero-terminated)
+    AssetView vertexCode, fragmentCode, geometryCode;
+    if (!ReadAsset(vShaderFile, vertexCode) || !ReadAsset(fShaderFile, fragmentCode) ||
+        (gShaderFile != nullptr && !ReadAsset(gShaderFile, geometryCode)))
+        std::cout << "ERROR::SHADER: Failed to read shader files" << std::endl;
+    const GLchar *vShaderCode = vertexCode.Data ? reinterpret_cast<const GLchar*>(vertexCode.Data) : "";
+    const GLchar *fShaderCode = fragmentCode.Data ? reinterpret_cast<const GLchar*>(fragmentCode.Data) : "";
+    const GLchar *gShaderCode = geometryCode.Data ? reinterpret_cast<const GLchar*>(geometryCode.Data) : "";
+    // 2. Try the binary cache; binaries are only valid for the exact sources and driver they were built with
     Shader shader;
-    shader.Compile(vShaderCode, fShaderCode, gShaderFile != nullptr ? gShaderCode : nullptr);
+    compiling = GL_FALSE;
+    cachePath.clear();
+    if (GLEW_ARB_get_program_binary)
+    {
+        GLuint64 key = Fnv1a(vShaderCode, vertexCode.Size + 1);
+        key = Fnv1a(fShaderCode, fragmentCode.Size + 1, key);
+        key = Fnv1a(gShaderCode, geometryCode.Size + 1, key);
+        key = Fnv1a(defines != nullptr ? std::string(defines) : std::string(), key);
+        key = Fnv1a(driverString(GL_VENDOR), key);
+        key = Fnv1a(driverString(GL_RENDERER), key);
+        key = Fnv1a(driverString(GL_VERSION), key);
+        std::stringstream path;
+        path << SHADER_CACHE_DIRECTORY << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+        cachePath = path.str();
+
+        std::ifstream file(cachePath.c_str(), std::ios::in | std::ios::binary);
+        GLuint format;
+        if (file.read(reinterpret_cast<char*>(&format), sizeof(format)))
+        {
+            std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            if (!binary.empty() && shader.LoadBinary(format, binary))
+                return shader;
+        }
+    }
+    // 3. Otherwise start compiling the shader object from source code
+    shader.BeginCompile(vShaderCode, fShaderCode, gShaderFile != nullptr ? gShaderCode : nullptr, defines);
+    compiling = GL_TRUE;
     return shader;
 }
 
+void ResourceManager::listFiles(const std::string &directory, std::vector<std::string> &names)
+{
+#ifdef _WIN32
+    _finddata_t entry;
+    intptr_t search = _findfirst((directory + "/*").c_str(), &entry);
+    if (search == -1)
+        return;
+    do
+        if (!(entry.attrib & _A_SUBDIR))
+            names.push_back(entry.name);
+    while (_findnext(search, &entry) == 0);
+    _findclose(search);
+#else
+    DIR *listing = opendir(directory.c_str());
+    if (listing == nullptr)
+        return;
+    struct stat status;
+    for (dirent *entry = readdir(listing); entry != nullptr; entry = readdir(listing))
+        if (stat((directory + "/" + entry->d_name).c_str(), &status) == 0 && S_ISREG(status.st_mode))
+            names.push_back(entry->d_name);
+    closedir(listing);
+#endif
+}
+
 Texture2D ResourceManager::loadTextureFromFile(const GLchar *file, GLboolean alpha)
 {
-    // Create Texture object
+    // Load image
+    DecodedImage image;
+    DecodeImage(file, alpha, image);
+    // Now generate texture
+    return createTexture(image);
+}
+
+GLboolean ResourceManager::readCompressedTexture(const std::string &file, GLboolean alpha, DecodedImage &image)
+{
+    std::string path = file.substr(0, file.rfind('.')) + ".dds";
+    std::shared_ptr<AssetView> asset = std::make_shared<AssetView>();
+    if (!ReadAsset(path, *asset))
+        return GL_FALSE;
+    if (asset->Size < static_cast<GLsizeiptr>(sizeof(DDS_header)))
+        return GL_FALSE;
+    DDS_header header;
+    std::memcpy(&header, asset->Data, sizeof(header));
+    GLsizeiptr offset = sizeof(DDS_header);
+    GLenum format = 0;
+    if (header.dwMagic != DDS_MAGIC || !(header.sPixelFormat.dwFlags & DDPF_FOURCC))
+        format = 0;
+    else if (header.sPixelFormat.dwFourCC == DDS_FOURCC_DXT1)
+        format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    else if (header.sPixelFormat.dwFourCC == DDS_FOURCC_DXT5)
+        format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    else if (header.sPixelFormat.dwFourCC == DDS_FOURCC_DX10 && asset->Size >= static_cast<GLsizeiptr>(offset + sizeof(DdsHeaderDX10)))
+    {
+        DdsHeaderDX10 extended;
+        std::memcpy(&extended, asset->Data + offset, sizeof(extended));
+        offset += sizeof(DdsHeaderDX10);
+        if (extended.DxgiFormat == DXGI_FORMAT_BC1_UNORM)
+            format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        else if (extended.DxgiFormat == DXGI_FORMAT_BC3_UNORM)
+            format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        else if (extended.DxgiFormat == DXGI_FORMAT_BC7_UNORM)
+            format = GL_COMPRESSED_RGBA_BPTC_UNORM;
+    }
+    if (format == 0)
+    {
+        std::cout << "ERROR::TEXTURE: " << path << " is not a DXT1, DXT5 or BC7 texture" << std::endl;
+        return GL_FALSE;
+    }
+    // Fall back to the image when the GPU can't sample the format, or it would add alpha the caller asked to be dropped
+    GLboolean supported = format == GL_COMPRESSED_RGBA_BPTC_UNORM ? GLEW_ARB_texture_compression_bptc : GLEW_EXT_texture_compression_s3tc;
+    if (!supported || (!alpha && format != GL_COMPRESSED_RGB_S3TC_DXT1_EXT))
+        return GL_FALSE;
+    GLuint levels = 1, chain = 1;
+    while ((std::max(header.dwWidth, header.dwHeight) >> chain) > 0)
+        ++chain;
+    if (header.dwFlags & DDSD_MIPMAPCOUNT)
+        levels = std::min(std::max(header.dwMipMapCount, 1u), chain);
+    GLsizeiptr size = 0;
+    for (GLuint level = 0; level < levels; ++level)
+        size += CompressedLevelSize(format, std::max(header.dwWidth >> level, 1u), std::max(header.dwHeight >> level, 1u));
+    if (asset->Size < offset + size)
+    {
+        std::cout << "ERROR::TEXTURE: " << path << " is truncated" << std::endl;
+        return GL_FALSE;
+    }
+    image.Width = header.dwWidth;
+    image.Height = header.dwHeight;
+    image.Alpha = format != GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    image.Format = format;
+    image.Levels = levels;
+    image.Pixels.clear();
+    image.External = asset->Data + offset;
+    image.Asset = asset;
+    return GL_TRUE;
+}
+
+GLboolean ResourceManager::readTextureCache(const std::string &path, GLboolean alpha, DecodedImage &image)
+{
+    std::shared_ptr<MappedFile> cached = std::make_shared<MappedFile>();
+    if (!cached->Open(path) || cached->Size < static_cast<GLsizeiptr>(sizeof(TextureCacheHeader)))
+        return GL_FALSE;
+    const TextureCacheHeader *header = reinterpret_cast<const TextureCacheHeader*>(cached->Data);
+    GLuint channels = alpha ? 4 : 3;
+    if (header->Magic != TEXTURE_CACHE_MAGIC || header->Version != TEXTURE_CACHE_VERSION || header->Channels != channels ||
+        cached->Size < static_cast<GLsizeiptr>(sizeof(TextureCacheHeader) + static_cast<GLuint64>(header->Width) * header->Height * channels))
+        return GL_FALSE; // Stale or truncated: decoding again overwrites it
+    image.Width = header->Width;
+    image.Height = header->Height;
+    image.Alpha = alpha;
+    image.Pixels.clear();
+    image.Cached = cached;
+    image.External = cached->Data + sizeof(TextureCacheHeader);
+    return GL_TRUE;
+}
+
+void ResourceManager::writeTextureCache(const std::string &path, const DecodedImage &image)
+{
+    MAKE_DIRECTORY("cache");
+    MAKE_DIRECTORY(TEXTURE_CACHE_DIRECTORY);
+    TextureCacheHeader header = TextureCacheHeader();
+    header.Magic = TEXTURE_CACHE_MAGIC;
+    header.Version = TEXTURE_CACHE_VERSION;
+    header.Width = image.Width;
+    header.Height = image.Height;
+    header.Channels = image.Alpha ? 4 : 3;
+    writeCacheFile(path, &header, sizeof(header), image.Pixels.data(), image.Pixels.size());
+}
+
+GLboolean ResourceManager::writeCacheFile(const std::string &path, const void *header, GLsizeiptr headerSize, const void *data, GLsizeiptr size)
+{
+    // Written under a name of its own and renamed into place, so no reader (or other writer of the same file) sees it half written
+    static std::atomic<GLuint> files(0);
+    std::stringstream temporary;
+    temporary << path << "." << files++ << ".tmp";
+    {
+        std::ofstream file(temporary.str().c_str(), std::ios::out | std::ios::binary);
+        file.write(static_cast<const char*>(header), headerSize);
+        file.write(static_cast<const char*>(data), size);
+        file.close();
+        if (!file)
+        {
+            std::remove(temporary.str().c_str());
+            return GL_FALSE;
+        }
+    }
+    if (std::rename(temporary.str().c_str(), path.c_str()) != 0)
+    {
+        // Windows doesn't rename onto an existing file
+        std::remove(path.c_str());
+        if (std::rename(temporary.str().c_str(), path.c_str()) != 0)
+        {
+            std::remove(temporary.str().c_str());
+            return GL_FALSE;
+        }
+    }
+    return GL_TRUE;
+}
+
+std::string ResourceManager::driverString(GLenum name)
+{
+    const GLubyte *value = glGetString(name);
+    return value != nullptr ? std::string(reinterpret_cast<const char*>(value)) : std::string();
+}
+
+Texture2D ResourceManager::createTexture(const DecodedImage &image)
+{
+    // Create Texture object (with mipmaps, so sprites drawn smaller than their images don't alias)
     Texture2D texture;
-    if (alpha)
+    texture.Filter_Min = GL_LINEAR_MIPMAP_LINEAR;
+    if (image.Format != 0)
+    {
+        texture.GenerateCompressed(image.Width, image.Height, image.Format, image.Levels, image.Data());
+        return texture;
+    }
+    if (image.Alpha)
     {
         texture.Internal_Format = GL_RGBA;
         texture.Image_Format = GL_RGBA;
     }
-    // Load image
-    int width, height;
-    unsigned char* image = SOIL_load_image(file, &width, &height, 0, texture.Image_Format == GL_RGBA ? SOIL_LOAD_RGBA : SOIL_LOAD_RGB);
-    // Now generate texture
-    texture.Generate(width, height, image);
-    // And finally free image data
-    SOIL_free_image_data(image);
+    texture.Mipmaps = GL_TRUE;
+    texture.Generate(image.Width, image.Height, const_cast<unsigned char*>(image.Data()));
     return texture;
+}
+
+void ResourceManager::storeTexture(GLuint index, Texture2D &&texture, const std::string &file, GLboolean alpha)
+{
+    TextureRecord &record = textureRecords[index];
+    textureMemory -= record.Bytes;
+    record.File = file;
+    record.Alpha = alpha;
+    record.Bytes = texture.Size;
+    textures[index] = std::move(texture); // Deletes the texture loaded there before
+    record.Resident = GL_TRUE;
+    textureMemory += record.Bytes;
+    evictTextures(index);
+}
+
+void ResourceManager::evictTextures(GLuint keep)
+{
+    while (textureBudget > 0 && textureMemory > textureBudget)
+    {
+        // Linear scan for the least recently used candidate; there are few textures and evictions are rare
+        GLuint victim = textures.size();
+        for (GLuint i = 0; i < textures.size(); ++i)
+        {
+            const TextureRecord &record = textureRecords[i];
+            if (i != keep && record.Resident && record.References == 0 && !record.File.empty() &&
+                (victim == textures.size() || record.LastUse < textureRecords[victim].LastUse))
+                victim = i;
+        }
+        if (victim == textures.size())
+            return; // Everything resident is held: over budget until something is released
+        textures[victim] = Texture2D();
+        textureMemory -= textureRecords[victim].Bytes;
+        textureRecords[victim].Bytes = 0;
+        textureRecords[victim].Resident = GL_FALSE;
+    }
 }
\ No newline at end of file
@@ -9,43 +9,195 @@
 #ifndef RESOURCE_MANAGER_H
 #define RESOURCE_MANAGER_H
 
+#include <deque>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <GL/glew.h>
 
 #include "texture.hpp"
 #include "shader.hpp"
+#include "asset_pack.hpp"
+#include "mapped_file.hpp"
 
 
+// Directory linked shader programs are cached in (keyed by a hash of their sources and the driver)
+#define SHADER_CACHE_DIRECTORY "cache/shaders"
+// Directory decoded texture pixels are cached in (keyed by a hash of the image file), so warm starts skip decoding
+#define TEXTURE_CACHE_DIRECTORY "cache/textures"
+// Identifies texture cache files ("BTEX")
+const GLuint TEXTURE_CACHE_MAGIC = 0x58455442;
+// Version of the texture cache; bump it whenever decoding or the file layout changes
+const GLuint TEXTURE_CACHE_VERSION = 1;
+// Asset pack built by the asset packer tool, served in place of the loose files when present
+#define ASSET_PACK_FILE "assets.pak"
+// Loose files of at least this many bytes are memory-mapped instead of read
+const GLsizeiptr ASSET_MAP_THRESHOLD = 64 * 1024;
+// Environment variable naming a directory whose files take precedence over the embedded assets (for development)
+#define ASSET_DIRECTORY_VARIABLE "BREAKOUT_ASSET_DIR"
+// Texture memory (in bytes) kept resident unless configured otherwise; 0 means no limit
+const GLsizeiptr DEFAULT_TEXTURE_BUDGET = 0;
+
+// Read-only bytes of an asset. Data points straight at the pack or
+// embedded copy when there is one, or into the mapping of a large
+// file, otherwise into Storage (read from disk). Data[Size] is always
+// a terminating zero, so text can be used in place. Views can be
+// moved but not copied (Data may point into Storage).
+struct AssetView {
+    const unsigned char         *Data;
+    GLsizeiptr                   Size;
+    std::vector<unsigned char>   Storage;
+    std::shared_ptr<MappedFile>  Mapping; // Keeps a mapped file alive
+    AssetView() : Data(nullptr), Size(0) { }
+    AssetView(AssetView &&other) = default;
+    AssetView(const AssetView &) = delete;
+    AssetView &operator=(const AssetView &) = delete;
+};
+
+// Header of a texture cache file; the decoded pixels follow it
+// exactly as SOIL returned them (rows tightly packed).
+struct TextureCacheHeader {
+    GLuint Magic;
+    GLuint Version;
+    GLuint Width, Height;
+    GLuint Channels; // 4 for RGBA, 3 for RGB
+    GLuint Reserved[3];
+};
+
+// Pixels of an image decoded on the CPU, not yet uploaded to a texture.
+// Pixels read from the texture cache or a compressed texture are used
+// in place (External points into the mapped file or the asset) and
+// Pixels stays empty.
+struct DecodedImage {
+    GLuint                      Width, Height;
+    GLboolean                   Alpha;  // RGBA if set, RGB otherwise
+    GLenum                      Format; // Block compressed format of the pixels (0: uncompressed)
+    GLuint                      Levels; // Number of mipmap levels in compressed pixels (uncompressed images get theirs generated)
+    std::vector<unsigned char>  Pixels;
+    std::string                 File;   // Asset the image was decoded from (empty if generated)
+    const unsigned char        *External; // Pixels held elsewhere (nullptr: in Pixels)
+    std::shared_ptr<MappedFile> Cached; // Maps the texture cache file the pixels are in
+    std::shared_ptr<AssetView>  Asset;  // Holds the compressed texture the pixels are in
+    DecodedImage() : Width(0), Height(0), Alpha(GL_FALSE), Format(0), Levels(1), External(nullptr) { }
+    // The pixels, wherever they are (nullptr if there are none)
+    const unsigned char *Data() const
+    {
+        if (this->External != nullptr)
+            return this->External;
+        return this->Pixels.empty() ? nullptr : this->Pixels.data();
+    }
+};
+
+// Index of a stored resource of type T. Resolved from the resource's
+// name once (e.g. at load time) so code that runs every frame or on
+// gameplay events retrieves the resource by array index instead of
+// by name. Handles of different resource types don't convert.
+template <typename T>
+struct ResourceHandle {
+    GLuint Index;
+    ResourceHandle() : Index(0) { }
+    explicit ResourceHandle(GLuint index) : Index(index) { }
+};
+typedef ResourceHandle<Texture2D> TextureHandle;
+typedef ResourceHandle<Shader>    ShaderHandle;
+
+// Memory accounting of a stored texture
+struct TextureRecord {
+    std::string File;       // Asset to reload the texture from after it was evicted (empty: it can't be, so it never is)
+    GLboolean   Alpha;
+    GLboolean   Resident;   // Whether the texture is loaded (and not evicted)
+    GLsizeiptr  Bytes;      // Texture memory in use (0 unless resident)
+    GLuint      References; // Number of holders keeping the texture resident
+    GLuint64    LastUse;    // Retrieval the texture was last returned by (orders the evictions)
+    TextureRecord() : Alpha(GL_FALSE), Resident(GL_FALSE), Bytes(0), References(0), LastUse(0) { }
+};
+
 // A static singleton ResourceManager class that hosts several
 // functions to load Textures and Shaders. Each loaded texture
 // and/or shader is also stored for future reference by string
-// handles. All functions and resources are static and no 
-// public constructor is defined.
+// names, which resolve to handles for quick access. Textures count
+// against a memory budget: beyond it the least recently used ones
+// nobody holds are evicted, and reloaded when next retrieved. All
+// functions and resources are static and no public constructor is
+// defined.
 class ResourceManager
 {
 public:
-    // Resource storage
-    static std::map<std::string, Shader>    Shaders;
-    static std::map<std::string, Texture2D> Textures;
-    // Loads (and generates) a shader program from file loading vertex, fragment (and geometry) shader's source code. If gShaderFile is not nullptr, it also loads a geometry shader
-    static Shader   LoadShader(const GLchar *vShaderFile, const GLchar *fShaderFile, const GLchar *gShaderFile, std::string name);
-    // Retrieves a stored sader
-    static Shader   GetShader(std::string name);
+    // Loads (and generates) a shader program from file loading vertex, fragment (and geometry) shader's source code. If gShaderFile is not nullptr, it also loads a geometry shader. Defines are injected into every stage (used to compile specialised permutations)
+    static Shader  &LoadShader(const GLchar *vShaderFile, const GLchar *fShaderFile, const GLchar *gShaderFile, std::string name, const GLchar *defines = nullptr);
+    // Starts loading a shader program like LoadShader, but returns without waiting for the driver to compile it. The program is completed by the first GetShader with its name, so queueing all shaders up front lets them compile in parallel
+    static void     QueueShader(const GLchar *vShaderFile, const GLchar *fShaderFile, const GLchar *gShaderFile, std::string name, const GLchar *defines = nullptr);
+    // Retrieves a stored sader (completing it first if it was queued); the reference stays valid until Clear, so renderers may keep it
+    static Shader  &GetShader(std::string name);
+    static Shader  &GetShader(ShaderHandle handle);
+    // Returns the handle of the shader with the given name; it may be resolved before the shader is loaded
+    static ShaderHandle  FindShader(const std::string &name);
     // Loads (and generates) a texture from file
-    static Texture2D LoadTexture(const GLchar *file, GLboolean alpha, std::string name);
-    // Retrieves a stored texture
-    static Texture2D GetTexture(std::string name);
-    // Properly de-allocates all loaded resources
+    static const Texture2D &LoadTexture(const GLchar *file, GLboolean alpha, std::string name);
+    // Generates a texture from an image decoded by DecodeImage and stores it
+    static const Texture2D &LoadTexture(const DecodedImage &image, std::string name);
+    // Decodes an image file without touching OpenGL, so it may be called from any thread. A compressed texture (.dds) next to the file is used instead when the GPU supports its format; otherwise the pixels are taken from the texture cache if it has them, and added to it if not
+    static GLboolean DecodeImage(const GLchar *file, GLboolean alpha, DecodedImage &image);
+    // Retrieves a stored texture (by name, for setup and tooling; by handle, without any lookup, everywhere else), reloading it if it was evicted
+    static const Texture2D &GetTexture(std::string name);
+    static const Texture2D &GetTexture(TextureHandle handle);
+    // Returns the handle of the texture with the given name; it may be resolved before the texture is loaded
+    static TextureHandle FindTexture(const std::string &name);
+    // Keeps a texture resident until the matching ReleaseTexture; code that stores a view of a texture (e.g. as a sprite) must hold it, as evicting deletes it
+    static void      AcquireTexture(TextureHandle handle);
+    static void      ReleaseTexture(TextureHandle handle);
+    // Sets the texture memory (in bytes) to keep resident, evicting textures right away if more is in use (0: no limit)
+    static void      SetTextureBudget(GLsizeiptr bytes);
+    // Texture memory in use, in bytes
+    static GLsizeiptr TextureMemory();
+    // Reads the asset at the given path (relative to the source tree): from the override directory if set and the file exists there, else a mounted pack, else the embedded copy, else the file itself
+    static GLboolean ReadAsset(const std::string &path, AssetView &asset);
+    // Lists the assets directly within the given directory (relative to the source tree) from all sources ReadAsset reads from, sorted by path
+    static void      ListAssets(const std::string &directory, std::vector<std::string> &paths);
+    // Memory-maps an asset pack and serves its assets from then on (packs mounted later take precedence); call before loading starts. Returns false if the pack can't be opened
+    static GLboolean MountPack(const std::string &path);
+    // Properly de-allocates all loaded resources; call before the GL context is destroyed and after everything holding them (their handles and references are invalid afterwards)
     static void      Clear();
 private:
     // Private constructor, that is we do not want any actual resource manager objects. Its members and functions should be publicly available (static).
     ResourceManager() { }
-    // Loads and generates a shader from file
-    static Shader    loadShaderFromFile(const GLchar *vShaderFile, const GLchar *fShaderFile, const GLchar *gShaderFile = nullptr);
+    // Resource storage (indexed by handle) and the handles of their names; shaders are kept in a deque, so adding more doesn't move those renderers refer to
+    static std::deque<Shader>                 shaders;
+    static std::vector<Texture2D>             textures;
+    static std::map<std::string, GLuint>      shaderNames;
+    static std::map<std::string, GLuint>      textureNames;
+    // Memory accounting of the textures (indexed by handle)
+    static std::vector<TextureRecord>         textureRecords;
+    static GLsizeiptr                         textureBudget, textureMemory;
+    static GLuint64                           textureRetrievals;
+    // Mounted packs, most recent first (they stay mapped until the process exits, as views may be held anywhere)
+    static std::vector<AssetPack *>           packs;
+    // Shaders still being compiled, by handle index, with the path their binary is to be cached at (empty if binaries are unsupported)
+    static std::map<GLuint, std::string>      pendingShaders;
+    // Loads a shader from file: from the binary cache if possible, otherwise its compile is started (compiling is set) and cachePath set to where its binary belongs
+    static Shader    loadShaderFromFile(const GLchar *vShaderFile, const GLchar *fShaderFile, const GLchar *gShaderFile, const GLchar *defines, GLboolean &compiling, std::string &cachePath);
+    // Appends the names of the files in the given directory of the file system
+    static void      listFiles(const std::string &directory, std::vector<std::string> &names);
     // Loads a single texture from file
     static Texture2D loadTextureFromFile(const GLchar *file, GLboolean alpha);
+    // Reads the compressed texture (.dds) of an image file into image (returns false if there is none, or it can't be used)
+    static GLboolean readCompressedTexture(const std::string &file, GLboolean alpha, DecodedImage &image);
+    // Maps the pixels cached in the given texture cache file into image (returns false if there is no valid one)
+    static GLboolean readTextureCache(const std::string &path, GLboolean alpha, DecodedImage &image);
+    // Stores the decoded pixels of an image file in the texture cache
+    static void      writeTextureCache(const std::string &path, const DecodedImage &image);
+    // Writes a cache file (header then data) through a temporary file renamed into place (returns false if it couldn't be written)
+    static GLboolean writeCacheFile(const std::string &path, const void *header, GLsizeiptr headerSize, const void *data, GLsizeiptr size);
+    // Returns a driver string (glGetString), or an empty one if the driver has none
+    static std::string driverString(GLenum name);
+    // Generates a texture from decoded pixels
+    static Texture2D createTexture(const DecodedImage &image);
+    // Stores a texture in the given slot (deleting the texture loaded there before, if any) and evicts others if it pushes the memory in use over budget
+    static void      storeTexture(GLuint index, Texture2D &&texture, const std::string &file, GLboolean alpha);
+    // Evicts the least recently used textures nobody holds (except the given one) until the memory in use is within budget
+    static void      evictTextures(GLuint keep);
 };
 
 #endif
\ No newline at end of file
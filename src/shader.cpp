@@ -8,107 +8,291 @@
 ******************************************************************/
 #include "shader.hpp"
 
+#include <cstring>
 #include <iostream>
+#include <utility>
+
+#include "gl_state.hpp"
+#include "uniform_buffer.hpp"
+
+Shader::~Shader()
+{
+    for (GLuint stage : this->stages)
+        if (stage != 0)
+            glDeleteShader(stage);
+    if (this->ID != 0)
+        GLState::DeleteProgram(this->ID);
+}
+
+Shader::Shader(Shader &&other) noexcept
+    : ID(0), stages()
+{
+    *this = std::move(other);
+}
+
+Shader &Shader::operator=(Shader &&other) noexcept
+{
+    if (this == &other)
+        return *this;
+    for (GLuint i = 0; i < 3; ++i)
+    {
+        if (this->stages[i] != 0)
+            glDeleteShader(this->stages[i]);
+        this->stages[i] = other.stages[i];
+        other.stages[i] = 0;
+    }
+    if (this->ID != 0)
+        GLState::DeleteProgram(this->ID);
+    this->ID = other.ID;
+    this->uniforms = std::move(other.uniforms);
+    other.ID = 0;
+    return *this;
+}
 
 Shader &Shader::Use()
 {
-    glUseProgram(this->ID);
+    GLState::UseProgram(this->ID);
     return *this;
 }
 
-void Shader::Compile(const GLchar* vertexSource, const GLchar* fragmentSource, const GLchar* geometrySource)
+void Shader::Compile(const GLchar* vertexSource, const GLchar* fragmentSource, const GLchar* geometrySource, const GLchar *defines)
+{
+    this->BeginCompile(vertexSource, fragmentSource, geometrySource, defines);
+    this->FinishCompile();
+}
+
+void Shader::BeginCompile(const GLchar* vertexSource, const GLchar* fragmentSource, const GLchar* geometrySource, const GLchar *defines)
 {
-    GLuint sVertex, sFragment, gShader;
+    // Nothing below queries compile or link results, so the driver is free to finish the work in the background
     // Vertex Shader
-    sVertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(sVertex, 1, &vertexSource, NULL);
-    glCompileShader(sVertex);
-    checkCompileErrors(sVertex, "VERTEX");
+    this->stages[0] = glCreateShader(GL_VERTEX_SHADER);
+    setSource(this->stages[0], vertexSource, defines);
+    glCompileShader(this->stages[0]);
     // Fragment Shader
-    sFragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(sFragment, 1, &fragmentSource, NULL);
-    glCompileShader(sFragment);
-    checkCompileErrors(sFragment, "FRAGMENT");
+    this->stages[1] = glCreateShader(GL_FRAGMENT_SHADER);
+    setSource(this->stages[1], fragmentSource, defines);
+    glCompileShader(this->stages[1]);
     // If geometry shader source code is given, also compile geometry shader
     if (geometrySource != nullptr)
     {
-        gShader = glCreateShader(GL_GEOMETRY_SHADER);
-        glShaderSource(gShader, 1, &geometrySource, NULL);
-        glCompileShader(gShader);
-        checkCompileErrors(gShader, "GEOMETRY");
+        this->stages[2] = glCreateShader(GL_GEOMETRY_SHADER);
+        setSource(this->stages[2], geometrySource, defines);
+        glCompileShader(this->stages[2]);
     }
     // Shader Program
     this->ID = glCreateProgram();
-    glAttachShader(this->ID, sVertex);
-    glAttachShader(this->ID, sFragment);
-    if (geometrySource != nullptr)
-        glAttachShader(this->ID, gShader);
+    for (GLuint stage : this->stages)
+        if (stage != 0)
+            glAttachShader(this->ID, stage);
+    if (GLEW_ARB_get_program_binary)
+        glProgramParameteri(this->ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(this->ID);
-    checkCompileErrors(this->ID, "PROGRAM");
+}
+
+GLboolean Shader::FinishCompile()
+{
+    static const char *stageNames[3] = { "VERTEX", "FRAGMENT", "GEOMETRY" };
+    for (GLuint i = 0; i < 3; ++i)
+        if (this->stages[i] != 0)
+            checkCompileErrors(this->stages[i], stageNames[i]);
+    GLboolean linked = checkCompileErrors(this->ID, "PROGRAM");
+    this->cacheUniforms();
     // Delete the shaders as they're linked into our program now and no longer necessery
-    glDeleteShader(sVertex);
-    glDeleteShader(sFragment);
-    if (geometrySource != nullptr)
-        glDeleteShader(gShader);
+    for (GLuint &stage : this->stages)
+    {
+        if (stage != 0)
+            glDeleteShader(stage);
+        stage = 0;
+    }
+    return linked;
+}
+
+GLboolean Shader::LoadBinary(GLenum format, const std::vector<char> &binary)
+{
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        glDeleteProgram(program); // Stale binary (e.g. the driver was updated); the caller compiles from source instead
+        return GL_FALSE;
+    }
+    this->ID = program;
+    this->cacheUniforms();
+    return GL_TRUE;
+}
+
+GLboolean Shader::GetBinary(GLenum &format, std::vector<char> &binary) const
+{
+    GLint length = 0;
+    glGetProgramiv(this->ID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return GL_FALSE;
+    binary.resize(length);
+    glGetProgramBinary(this->ID, length, NULL, &format, binary.data());
+    return GL_TRUE;
+}
+
+void Shader::setSource(GLuint shader, const GLchar *source, const GLchar *defines)
+{
+    if (defines == nullptr || *defines == '\0')
+    {
+        glShaderSource(shader, 1, &source, NULL);
+        return;
+    }
+    // The defines have to follow the #version directive, which must come first
+    const GLchar *body = source;
+    if (const GLchar *version = std::strstr(source, "#version"))
+    {
+        const GLchar *lineEnd = std::strchr(version, '\n');
+        body = lineEnd != nullptr ? lineEnd + 1 : version + std::strlen(version);
+    }
+    std::string header(source, body);
+    if (!header.empty() && header[header.size() - 1] != '\n')
+        header += '\n';
+    const GLchar *sources[3] = { header.c_str(), defines, body };
+    glShaderSource(shader, 3, sources, NULL);
+}
+
+GLint Shader::Uniform(const GLchar *name) const
+{
+    std::map<std::string, GLint>::const_iterator it = this->uniforms.Handles.find(name);
+    return it != this->uniforms.Handles.end() ? it->second : -1;
 }
 
 void Shader::SetFloat(const GLchar *name, GLfloat value, GLboolean useShader)
 {
     if (useShader)
         this->Use();
-    glUniform1f(glGetUniformLocation(this->ID, name), value);
+    this->SetFloat(this->Uniform(name), value);
 }
 void Shader::SetInteger(const GLchar *name, GLint value, GLboolean useShader)
 {
     if (useShader)
         this->Use();
-    glUniform1i(glGetUniformLocation(this->ID, name), value);
+    this->SetInteger(this->Uniform(name), value);
 }
 void Shader::SetVector2f(const GLchar *name, GLfloat x, GLfloat y, GLboolean useShader)
 {
     if (useShader)
         this->Use();
-    glUniform2f(glGetUniformLocation(this->ID, name), x, y);
+    this->SetVector2f(this->Uniform(name), glm::vec2(x, y));
 }
 void Shader::SetVector2f(const GLchar *name, const glm::vec2 &value, GLboolean useShader)
 {
     if (useShader)
         this->Use();
-    glUniform2f(glGetUniformLocation(this->ID, name), value.x, value.y);
+    this->SetVector2f(this->Uniform(name), value);
 }
 void Shader::SetVector3f(const GLchar *name, GLfloat x, GLfloat y, GLfloat z, GLboolean useShader)
 {
     if (useShader)
         this->Use();
-    glUniform3f(glGetUniformLocation(this->ID, name), x, y, z);
+    this->SetVector3f(this->Uniform(name), glm::vec3(x, y, z));
 }
 void Shader::SetVector3f(const GLchar *name, const glm::vec3 &value, GLboolean useShader)
 {
     if (useShader)
         this->Use();
-    glUniform3f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z);
+    this->SetVector3f(this->Uniform(name), value);
 }
 void Shader::SetVector4f(const GLchar *name, GLfloat x, GLfloat y, GLfloat z, GLfloat w, GLboolean useShader)
 {
     if (useShader)
         this->Use();
-    glUniform4f(glGetUniformLocation(this->ID, name), x, y, z, w);
+    this->SetVector4f(this->Uniform(name), glm::vec4(x, y, z, w));
 }
 void Shader::SetVector4f(const GLchar *name, const glm::vec4 &value, GLboolean useShader)
 {
     if (useShader)
         this->Use();
-    glUniform4f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z, value.w);
+    this->SetVector4f(this->Uniform(name), value);
 }
 void Shader::SetMatrix4(const GLchar *name, const glm::mat4 &matrix, GLboolean useShader)
 {
     if (useShader)
         this->Use();
-    glUniformMatrix4fv(glGetUniformLocation(this->ID, name), 1, GL_FALSE, glm::value_ptr(matrix));
+    this->SetMatrix4(this->Uniform(name), matrix);
+}
+
+void Shader::SetFloat(GLint handle, GLfloat value)
+{
+    if (UniformSlot *slot = this->changedSlot(handle, &value, sizeof(value)))
+        glUniform1f(slot->Location, value);
+}
+void Shader::SetInteger(GLint handle, GLint value)
+{
+    if (UniformSlot *slot = this->changedSlot(handle, &value, sizeof(value)))
+        glUniform1i(slot->Location, value);
+}
+void Shader::SetVector2f(GLint handle, const glm::vec2 &value)
+{
+    if (UniformSlot *slot = this->changedSlot(handle, glm::value_ptr(value), sizeof(value)))
+        glUniform2f(slot->Location, value.x, value.y);
+}
+void Shader::SetVector3f(GLint handle, const glm::vec3 &value)
+{
+    if (UniformSlot *slot = this->changedSlot(handle, glm::value_ptr(value), sizeof(value)))
+        glUniform3f(slot->Location, value.x, value.y, value.z);
+}
+void Shader::SetVector4f(GLint handle, const glm::vec4 &value)
+{
+    if (UniformSlot *slot = this->changedSlot(handle, glm::value_ptr(value), sizeof(value)))
+        glUniform4f(slot->Location, value.x, value.y, value.z, value.w);
+}
+void Shader::SetMatrix4(GLint handle, const glm::mat4 &matrix)
+{
+    if (UniformSlot *slot = this->changedSlot(handle, glm::value_ptr(matrix), sizeof(matrix)))
+        glUniformMatrix4fv(slot->Location, 1, GL_FALSE, glm::value_ptr(matrix));
+}
+
+UniformSlot *Shader::changedSlot(GLint handle, const void *value, GLsizei size)
+{
+    if (handle < 0 || handle >= static_cast<GLint>(this->uniforms.Slots.size()))
+        return nullptr;
+    UniformSlot &slot = this->uniforms.Slots[handle];
+    if (slot.Valid && std::memcmp(slot.Value, value, size) == 0)
+        return nullptr; // Program already holds this value
+    std::memcpy(slot.Value, value, size);
+    slot.Valid = GL_TRUE;
+    return &slot;
+}
+
+void Shader::cacheUniforms()
+{
+    this->uniforms = UniformTable();
+    // Resolve the location of every active uniform once, so no lookups by string happen while rendering
+    GLint count = 0;
+    glGetProgramiv(this->ID, GL_ACTIVE_UNIFORMS, &count);
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLchar name[256];
+        GLint size;
+        GLenum type;
+        glGetActiveUniform(this->ID, i, sizeof(name), NULL, &size, &type, name);
+        GLint location = glGetUniformLocation(this->ID, name);
+        if (location < 0)
+            continue; // Member of a uniform block
+        // Arrays are reported as "name[0]"; register them by their plain name as well
+        std::string key(name);
+        std::string::size_type bracket = key.find('[');
+        if (bracket != std::string::npos)
+            key = key.substr(0, bracket);
+        UniformSlot slot;
+        slot.Location = location;
+        slot.Valid = GL_FALSE;
+        this->uniforms.Handles[key] = static_cast<GLint>(this->uniforms.Slots.size());
+        this->uniforms.Slots.push_back(slot);
+    }
+    // Bind the per-frame uniform block (if used by this program) to its shared binding point
+    GLuint frameBlock = glGetUniformBlockIndex(this->ID, FRAME_UNIFORM_BLOCK);
+    if (frameBlock != GL_INVALID_INDEX)
+        glUniformBlockBinding(this->ID, frameBlock, FRAME_UNIFORM_BINDING);
 }
 
 
-void Shader::checkCompileErrors(GLuint object, std::string type)
+GLboolean Shader::checkCompileErrors(GLuint object, std::string type)
 {
     GLint success;
     GLchar infoLog[1024];
@@ -134,4 +318,5 @@ void Shader::checkCompileErrors(GLuint object, std::string type)
                 << std::endl;
         }
     }
+    return success ? GL_TRUE : GL_FALSE;
 }
\ No newline at end of file
@@ -9,28 +9,62 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 
+// Cached state of a single active uniform: its location and the
+// value last written to it (so identical writes can be skipped).
+struct UniformSlot {
+    GLint     Location;
+    GLboolean Valid;     // Whether Value holds what the program currently has
+    GLfloat   Value[16]; // Raw bits of the last written value (large enough for a mat4)
+};
+
+// Uniform table of a linked program. Built once at link time.
+struct UniformTable {
+    std::map<std::string, GLint> Handles; // Uniform name -> index into Slots
+    std::vector<UniformSlot>     Slots;
+};
+
+
 // General purpsoe shader object. Compiles from file, generates
-// compile/link-time error messages and hosts several utility 
-// functions for easy management.
+// compile/link-time error messages and hosts several utility
+// functions for easy management. It owns its program, deleting it
+// when destroyed, so it can be moved but not copied; renderers refer
+// to the shaders the ResourceManager stores.
 class Shader
 {
 public:
     // State
-    GLuint ID; 
-    // Constructor
-    Shader() { }
+    GLuint ID;
+    // Constructor/Destructor
+    Shader() : ID(0), stages() { }
+    ~Shader();
+    Shader(Shader &&other) noexcept;
+    Shader &operator=(Shader &&other) noexcept;
+    Shader(const Shader &) = delete;
+    Shader &operator=(const Shader &) = delete;
     // Sets the current shader as active
     Shader  &Use();
-    // Compiles the shader from given source code
-    void    Compile(const GLchar *vertexSource, const GLchar *fragmentSource, const GLchar *geometrySource = nullptr); // Note: geometry source code is optional 
-    // Utility functions
+    // Compiles the shader from given source code; defines (e.g. "#define CHAOS\n") are injected after the #version directive of each stage
+    void    Compile(const GLchar *vertexSource, const GLchar *fragmentSource, const GLchar *geometrySource = nullptr, const GLchar *defines = nullptr); // Note: geometry source code and defines are optional
+    // Issues the compile and link of Compile without waiting for the driver (which may compile several programs in parallel); FinishCompile completes it
+    void    BeginCompile(const GLchar *vertexSource, const GLchar *fragmentSource, const GLchar *geometrySource = nullptr, const GLchar *defines = nullptr);
+    // Waits for the compile issued by BeginCompile, reports its errors and caches the uniform table; returns whether linking succeeded
+    GLboolean FinishCompile();
+    // Creates the program from a binary previously retrieved with GetBinary; returns false (and creates no program) if the driver rejects it
+    GLboolean LoadBinary(GLenum format, const std::vector<char> &binary);
+    // Retrieves the binary of the linked program (requires ARB_get_program_binary)
+    GLboolean GetBinary(GLenum &format, std::vector<char> &binary) const;
+    // Returns a handle to the given uniform for use with the handle-based setters below (-1 if the program has no such uniform)
+    GLint   Uniform(const GLchar *name) const;
+    // Utility functions (by name, resolved through the cached uniform table)
     void    SetFloat    (const GLchar *name, GLfloat value, GLboolean useShader = false);
     void    SetInteger  (const GLchar *name, GLint value, GLboolean useShader = false);
     void    SetVector2f (const GLchar *name, GLfloat x, GLfloat y, GLboolean useShader = false);
@@ -40,9 +74,26 @@ public:
     void    SetVector4f (const GLchar *name, GLfloat x, GLfloat y, GLfloat z, GLfloat w, GLboolean useShader = false);
     void    SetVector4f (const GLchar *name, const glm::vec4 &value, GLboolean useShader = false);
     void    SetMatrix4  (const GLchar *name, const glm::mat4 &matrix, GLboolean useShader = false);
+    // Utility functions (by handle, as returned by Uniform); the shader must be active
+    void    SetFloat    (GLint handle, GLfloat value);
+    void    SetInteger  (GLint handle, GLint value);
+    void    SetVector2f (GLint handle, const glm::vec2 &value);
+    void    SetVector3f (GLint handle, const glm::vec3 &value);
+    void    SetVector4f (GLint handle, const glm::vec4 &value);
+    void    SetMatrix4  (GLint handle, const glm::mat4 &matrix);
 private:
-    // Checks if compilation or linking failed and if so, print the error logs
-    void    checkCompileErrors(GLuint object, std::string type); 
+    // Uniform locations and last written values
+    UniformTable uniforms;
+    // Shader objects of a compile in progress (vertex, fragment, geometry)
+    GLuint  stages[3];
+    // Sets the source of a shader stage, injecting the given defines
+    void    setSource(GLuint shader, const GLchar *source, const GLchar *defines);
+    // Checks if compilation or linking failed and if so, print the error logs (returns whether it succeeded)
+    GLboolean checkCompileErrors(GLuint object, std::string type);
+    // Queries all active uniforms of the linked program and binds the shared uniform blocks
+    void    cacheUniforms();
+    // Returns the slot of the given handle if the value differs from the cached one (and caches it), nullptr otherwise
+    UniformSlot *changedSlot(GLint handle, const void *value, GLsizei size);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "sound_bank.hpp"
+
+#include <iostream>
+
+using namespace irrklang;
+
+
+SoundBank::SoundBank(ISoundEngine *engine, GLuint voices, GLfloat window)
+    : engine(engine), capacity(voices), window(window), clock(0.0f)
+{
+    this->voices.reserve(voices);
+}
+
+SoundBank::~SoundBank()
+{
+    while (!this->voices.empty())
+        this->stopVoice(this->voices.size() - 1);
+}
+
+SoundHandle SoundBank::Load(const GLchar *file, GLuint priority)
+{
+    Effect effect;
+    effect.Source = nullptr;
+    effect.Priority = priority;
+    effect.LastPlay = -1.0f;
+    AssetView sound;
+    if (this->engine != nullptr && ResourceManager::ReadAsset(file, sound))
+    {
+        // Views into a pack or the executable aren't copied, as they outlive the engine
+        effect.Source = this->engine->addSoundSourceFromMemory(const_cast<unsigned char*>(sound.Data), static_cast<ik_s32>(sound.Size), file, !sound.Storage.empty() || sound.Mapping);
+        if (effect.Source != nullptr)
+        {
+            // Keep the whole effect decoded in memory, and decode it now rather than on its first play
+            effect.Source->setForcedStreamingThreshold(0);
+            effect.Source->setStreamMode(ESM_NO_STREAMING);
+            effect.Source->getSampleData();
+        }
+    }
+    if (this->engine != nullptr && effect.Source == nullptr)
+        std::cout << "ERROR::SOUNDBANK: Failed to load " << file << std::endl;
+    this->effects.push_back(effect);
+    return SoundHandle(this->effects.size() - 1);
+}
+
+void SoundBank::Play(SoundHandle sound)
+{
+    Effect &effect = this->effects[sound.Index];
+    if (effect.Source == nullptr)
+        return;
+    // A burst of plays sounds like one: merge them into the first
+    if (effect.LastPlay >= 0.0f && this->clock - effect.LastPlay < this->window)
+        return;
+    if (this->voices.size() >= this->capacity)
+    {
+        // Take the voice of the lowest priority (the oldest of those) that isn't above this effect's
+        GLuint victim = this->voices.size();
+        for (GLuint i = 0; i < this->voices.size(); ++i)
+        {
+            const Voice &voice = this->voices[i];
+            if (voice.Priority <= effect.Priority && (victim == this->voices.size() || voice.Priority < this->voices[victim].Priority ||
+                (voice.Priority == this->voices[victim].Priority && voice.Start < this->voices[victim].Start)))
+                victim = i;
+        }
+        if (victim == this->voices.size())
+            return; // Every voice plays something more important
+        this->stopVoice(victim);
+    }
+    // Tracked, so the voice can be stopped and tell when it finished
+    ISound *playing = this->engine->play2D(effect.Source, false, false, true);
+    if (playing == nullptr)
+        return;
+    effect.LastPlay = this->clock;
+    Voice voice;
+    voice.Sound = playing;
+    voice.Priority = effect.Priority;
+    voice.Start = this->clock;
+    this->voices.push_back(voice);
+}
+
+void SoundBank::Update(GLfloat dt)
+{
+    this->clock += dt;
+    for (GLuint i = 0; i < this->voices.size();)
+    {
+        if (this->voices[i].Sound->isFinished())
+            this->stopVoice(i);
+        else
+            ++i;
+    }
+}
+
+void SoundBank::stopVoice(GLuint index)
+{
+    // The pool is unordered (voices are ranked by priority and start), so the last voice fills the gap
+    this->voices[index].Sound->stop();
+    this->voices[index].Sound->drop();
+    this->voices[index] = this->voices.back();
+    this->voices.pop_back();
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef SOUND_BANK_H
+#define SOUND_BANK_H
+#include <vector>
+
+#include <GL/glew.h>
+#include <irrKlang.h>
+
+#include "resource_manager.hpp"
+
+
+// Maximum number of sound effects playing at once
+const GLuint  SOUND_VOICES = 8;
+// Plays of a sound within this many seconds of its last play are merged into that one
+const GLfloat SOUND_COALESCE_WINDOW = 0.05f;
+
+typedef ResourceHandle<irrklang::ISoundSource> SoundHandle;
+
+// SoundBank plays the game's sound effects. Each effect is decoded
+// to PCM once when loaded, and played from its sound source (no
+// lookup by file name, no decoding). At most SOUND_VOICES effects
+// play at once: a play beyond that replaces the oldest voice of the
+// lowest priority, or is dropped if every voice plays something more
+// important. Plays of the same effect in quick succession are merged,
+// so a burst of collisions costs one voice per effect. Without a
+// sound engine (no audio device) everything is a no-op.
+class SoundBank
+{
+public:
+    // Constructor/Destructor (the engine must outlive the bank)
+    SoundBank(irrklang::ISoundEngine *engine, GLuint voices = SOUND_VOICES, GLfloat window = SOUND_COALESCE_WINDOW);
+    ~SoundBank();
+    // Loads and decodes a sound effect; plays of higher priority may take the voices of lower ones
+    SoundHandle Load(const GLchar *file, GLuint priority);
+    // Plays a sound effect (unless merged into a recent play of it, or no voice is free for it)
+    void        Play(SoundHandle sound);
+    // Advances the bank's clock and frees the voices whose sound finished
+    void        Update(GLfloat dt);
+private:
+    // A loaded effect
+    struct Effect {
+        irrklang::ISoundSource *Source;
+        GLuint                  Priority;
+        GLfloat                 LastPlay; // Clock at its last play (negative: never played)
+    };
+    // A playing effect
+    struct Voice {
+        irrklang::ISound *Sound;
+        GLuint            Priority;
+        GLfloat           Start;
+    };
+    irrklang::ISoundEngine *engine;
+    std::vector<Effect>     effects;  // Indexed by handle
+    std::vector<Voice>      voices;   // Never more than capacity
+    GLuint                  capacity;
+    GLfloat                 window;
+    GLfloat                 clock;    // Seconds since the bank was created
+    // Stops a voice and removes it from the pool
+    void        stopVoice(GLuint index);
+};
+
+#endif
\ No newline at end of file
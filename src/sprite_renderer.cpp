@@ -7,49 +7,55 @@
 ** option) any later version.
 ******************************************************************/
 #include "sprite_renderer.hpp"
+#include "gl_state.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+// Bytes of instance data the sprite renderer can stream per frame
+static const GLsizeiptr INSTANCE_STREAM_SIZE = 4 * 1024 * 1024;
 
 
 SpriteRenderer::SpriteRenderer(Shader &shader)
+    : shader(shader), instanceStream(GL_ARRAY_BUFFER, INSTANCE_STREAM_SIZE)
 {
-    this->shader = shader;
     this->initRenderData();
 }
 
-SpriteRenderer::~SpriteRenderer()
-{
-    glDeleteVertexArrays(1, &this->quadVAO);
-}
-
-void SpriteRenderer::DrawSprite(Texture2D &texture, glm::vec2 position, glm::vec2 size, GLfloat rotate, glm::vec3 color)
+void SpriteRenderer::DrawSprite(TextureView texture, glm::vec2 position, glm::vec2 size, GLfloat rotate, glm::vec3 color)
 {
-    // Prepare transformations
-    this->shader.Use();
-    glm::mat4 model;
-    model = glm::translate(model, glm::vec3(position, 0.0f));  // First translate (transformations are: scale happens first, then rotation and then finall translation happens; reversed order)
-
-    model = glm::translate(model, glm::vec3(0.5f * size.x, 0.5f * size.y, 0.0f)); // Move origin of rotation to center of quad
-    model = glm::rotate(model, rotate, glm::vec3(0.0f, 0.0f, 1.0f)); // Then rotate
-    model = glm::translate(model, glm::vec3(-0.5f * size.x, -0.5f * size.y, 0.0f)); // Move origin back
-
-    model = glm::scale(model, glm::vec3(size, 1.0f)); // Last scale
-
-    this->shader.SetMatrix4("model", model);
+    // Prepare transformations (applied per instance in the vertex shader)
+    SpriteInstance instance;
+    instance.Rect = glm::vec4(position, size);
+    instance.Color = glm::vec4(color, 1.0f);
+    instance.Rotation = rotate;
 
     // Render textured quad
-    this->shader.SetVector3f("spriteColor", color);
-
-    glActiveTexture(GL_TEXTURE0);
+    this->shader.Use();
+    GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::ActiveTexture(GL_TEXTURE0);
     texture.Bind();
+    this->DrawInstances(&instance, 1);
+}
 
-    glBindVertexArray(this->quadVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
+void SpriteRenderer::DrawInstances(const SpriteInstance *instances, GLsizei count)
+{
+    // Write the instances into this frame's part of the instance stream
+    GLintptr offset;
+    void *data = this->instanceStream.Map(count * sizeof(SpriteInstance), offset);
+    if (data == nullptr)
+        return;
+    std::memcpy(data, instances, count * sizeof(SpriteInstance));
+    this->instanceStream.Unmap();
+    // And draw them from there
+    GLState::BindVertexArray(this->quadVAO.ID);
+    this->setInstanceAttributes(offset);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
 }
 
 void SpriteRenderer::initRenderData()
 {
     // Configure VAO/VBO
-    GLuint VBO;
     GLfloat vertices[] = { 
         // Pos      // Tex
         0.0f, 1.0f, 0.0f, 1.0f,
@@ -61,15 +67,29 @@ void SpriteRenderer::initRenderData()
         1.0f, 0.0f, 1.0f, 0.0f
     };
 
-    glGenVertexArrays(1, &this->quadVAO);
-    glGenBuffers(1, &VBO);
+    this->quadVAO = GenVertexArray();
+    this->quadVBO = GenBuffer();
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->quadVBO.ID);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindVertexArray(this->quadVAO);
+    GLState::BindVertexArray(this->quadVAO.ID);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid*)0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+
+    // Per-instance attributes: rect, color and rotation
+    for (GLuint attribute = 1; attribute <= 3; ++attribute)
+    {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+    this->setInstanceAttributes(0);
+}
+
+void SpriteRenderer::setInstanceAttributes(GLintptr offset)
+{
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->instanceStream.Buffer.ID);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (GLvoid*)(offset + offsetof(SpriteInstance, Rect)));
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (GLvoid*)(offset + offsetof(SpriteInstance, Color)));
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (GLvoid*)(offset + offsetof(SpriteInstance, Rotation)));
 }
\ No newline at end of file
@@ -15,23 +15,38 @@
 
 #include "texture.hpp"
 #include "shader.hpp"
+#include "gl_object.hpp"
+#include "stream_buffer.hpp"
+
+
+// Per-instance data of a textured quad. Consumed as instanced
+// vertex attributes 1-3 by both the sprite and particle shaders.
+struct SpriteInstance {
+    glm::vec4 Rect;     // <vec2 position, vec2 size>
+    glm::vec4 Color;
+    GLfloat   Rotation; // Rotation (radians) around the center of the quad
+};
 
 
 class SpriteRenderer
 {
 public:
-    // Constructor (inits shaders/shapes)
+    // Constructor (inits shaders/shapes; the shader must outlive the renderer)
     SpriteRenderer(Shader &shader);
-    // Destructor
-    ~SpriteRenderer();
     // Renders a defined quad textured with given sprite
-    void DrawSprite(Texture2D &texture, glm::vec2 position, glm::vec2 size = glm::vec2(10, 10), GLfloat rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f));
+    void DrawSprite(TextureView texture, glm::vec2 position, glm::vec2 size = glm::vec2(10, 10), GLfloat rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f));
+    // Renders count instances of the quad in a single draw call with the currently active shader, texture and blend mode
+    void DrawInstances(const SpriteInstance *instances, GLsizei count);
 private:
     // Render state
-    Shader shader; 
-    GLuint quadVAO;
+    Shader            &shader;
+    VertexArrayObject quadVAO;
+    BufferObject      quadVBO;
+    StreamBuffer instanceStream; // Per-frame instance data
     // Initializes and configures the quad's buffer and vertex attributes
     void initRenderData();
+    // Points the per-instance attributes at the instance data starting at the given offset of the instance stream
+    void setInstanceAttributes(GLintptr offset);
 };
 
 #endif
\ No newline at end of file
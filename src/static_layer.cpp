@@ -0,0 +1,145 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "static_layer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "gl_state.hpp"
+
+
+StaticLayer::StaticLayer(Shader &shader, GLuint canvasWidth, GLuint canvasHeight)
+    : Texture(), Width(canvasWidth), Height(canvasHeight), shader(shader), canvas(canvasWidth, canvasHeight), invalid(GL_TRUE)
+{
+    this->Texture.Wrap_S = GL_CLAMP_TO_EDGE;
+    this->Texture.Wrap_T = GL_CLAMP_TO_EDGE;
+    this->FBO = GenFramebuffer();
+    this->allocate();
+    this->initRenderData();
+    this->shader.SetInteger("image", 0, GL_TRUE);
+}
+
+void StaticLayer::Invalidate()
+{
+    this->invalid = GL_TRUE;
+    this->dirty.clear();
+}
+
+void StaticLayer::MarkDirty(glm::vec2 position, glm::vec2 size)
+{
+    if (this->invalid)
+        return; // Everything gets redrawn anyway
+    glm::vec4 rect(position, size);
+    if (this->dirty.size() < STATIC_LAYER_MAX_DIRTY)
+    {
+        this->dirty.push_back(rect);
+        return;
+    }
+    // Too many separate regions: merge them all into their bounding rectangle to bound the number of redraws
+    glm::vec2 min = position, max = position + size;
+    for (const glm::vec4 &r : this->dirty)
+    {
+        min = glm::min(min, glm::vec2(r.x, r.y));
+        max = glm::max(max, glm::vec2(r.x + r.z, r.y + r.w));
+    }
+    this->dirty.clear();
+    this->dirty.push_back(glm::vec4(min, max - min));
+}
+
+void StaticLayer::Resize(GLuint width, GLuint height)
+{
+    if (width == this->Width && height == this->Height)
+        return;
+    this->Width = width;
+    this->Height = height;
+    this->allocate();
+}
+
+void StaticLayer::Update(RenderQueue &queue, TextureView background, GameLevel &level)
+{
+    if (!this->invalid && this->dirty.empty())
+        return;
+    if (this->invalid)
+        this->dirty.assign(1, glm::vec4(glm::vec2(0.0f), this->canvas));
+
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, this->FBO.ID);
+    glViewport(0, 0, this->Width, this->Height);
+    glEnable(GL_SCISSOR_TEST);
+    glm::vec2 pixelsPerUnit = glm::vec2(this->Width, this->Height) / this->canvas;
+    for (const glm::vec4 &rect : this->dirty)
+    {
+        // Snap the region outwards to whole pixels; scissor coordinates have their origin at the bottom-left
+        GLint x0 = std::max(0, static_cast<GLint>(std::floor(rect.x * pixelsPerUnit.x)));
+        GLint y0 = std::max(0, static_cast<GLint>(std::floor(rect.y * pixelsPerUnit.y)));
+        GLint x1 = std::min(static_cast<GLint>(this->Width), static_cast<GLint>(std::ceil((rect.x + rect.z) * pixelsPerUnit.x)));
+        GLint y1 = std::min(static_cast<GLint>(this->Height), static_cast<GLint>(std::ceil((rect.y + rect.w) * pixelsPerUnit.y)));
+        if (x1 <= x0 || y1 <= y0)
+            continue;
+        glScissor(x0, this->Height - y1, x1 - x0, y1 - y0);
+        // Redraw everything static that overlaps the region; the scissor clips it to the region itself
+        queue.SubmitSprite(LAYER_BACKGROUND, background, glm::vec2(0.0f, 0.0f), this->canvas);
+        for (GameObject &tile : level.Bricks)
+            if (!tile.Destroyed &&
+                tile.Position.x < rect.x + rect.z && tile.Position.x + tile.Size.x > rect.x &&
+                tile.Position.y < rect.y + rect.w && tile.Position.y + tile.Size.y > rect.y)
+                tile.Draw(queue, LAYER_LEVEL);
+        queue.Flush();
+    }
+    glDisable(GL_SCISSOR_TEST);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    this->dirty.clear();
+    this->invalid = GL_FALSE;
+}
+
+void StaticLayer::Draw()
+{
+    // The layer is opaque, so it simply replaces whatever is below it
+    this->shader.Use();
+    GLState::ActiveTexture(GL_TEXTURE0);
+    this->Texture.Bind();
+    GLState::BindVertexArray(this->VAO.ID);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+void StaticLayer::allocate()
+{
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, this->FBO.ID);
+    this->Texture.Generate(this->Width, this->Height, NULL);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->Texture.ID, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::STATICLAYER: Failed to initialize FBO" << std::endl;
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+    this->Invalidate();
+}
+
+void StaticLayer::initRenderData()
+{
+    // Configure VAO/VBO
+    GLfloat vertices[] = {
+        // Pos        // Tex
+        -1.0f, -1.0f, 0.0f, 0.0f,
+         1.0f,  1.0f, 1.0f, 1.0f,
+        -1.0f,  1.0f, 0.0f, 1.0f,
+
+        -1.0f, -1.0f, 0.0f, 0.0f,
+         1.0f, -1.0f, 1.0f, 0.0f,
+         1.0f,  1.0f, 1.0f, 1.0f
+    };
+    this->VAO = GenVertexArray();
+    this->VBO = GenBuffer();
+
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->VBO.ID);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    GLState::BindVertexArray(this->VAO.ID);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GL_FLOAT), (GLvoid*)0);
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef STATIC_LAYER_H
+#define STATIC_LAYER_H
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "texture.hpp"
+#include "shader.hpp"
+#include "gl_object.hpp"
+#include "render_queue.hpp"
+#include "game_level.hpp"
+
+
+// Maximum number of separate dirty rectangles kept per frame; beyond this they are merged into one
+const GLuint STATIC_LAYER_MAX_DIRTY = 8;
+
+// StaticLayer caches the parts of the scene that don't move (the
+// background and the level's bricks) in an offscreen texture. Only
+// the regions marked dirty (e.g. where a brick got destroyed) are
+// re-rendered; each frame the cached texture is composited under
+// the dynamic objects with a single full-screen quad.
+class StaticLayer
+{
+public:
+    // State
+    Texture2D Texture;
+    GLuint    Width, Height; // Size of the layer in pixels
+    // Constructor (the layer covers a canvas of the given size in scene coordinates; initially one pixel per unit; the shader must outlive the layer)
+    StaticLayer(Shader &shader, GLuint canvasWidth, GLuint canvasHeight);
+    // Marks the whole layer for re-rendering (e.g. after a level reset)
+    void Invalidate();
+    // Marks the given region (in scene coordinates) for re-rendering
+    void MarkDirty(glm::vec2 position, glm::vec2 size);
+    // Changes the layer's size in pixels (and invalidates it)
+    void Resize(GLuint width, GLuint height);
+    // Re-renders the dirty regions of the layer with the given background and level
+    void Update(RenderQueue &queue, TextureView background, GameLevel &level);
+    // Draws the cached layer onto the currently bound framebuffer
+    void Draw();
+private:
+    // Render state
+    Shader            &shader;
+    FramebufferObject FBO;
+    VertexArrayObject VAO;
+    BufferObject      VBO;
+    glm::vec2         canvas; // Size of the scene in scene coordinates
+    // Pending regions, as <vec2 position, vec2 size>
+    std::vector<glm::vec4> dirty;
+    GLboolean              invalid; // Whether the whole layer must be re-rendered
+    // (Re)allocates the layer's texture
+    void allocate();
+    // Initialize quad for compositing the layer
+    void initRenderData();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,141 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "stream_buffer.hpp"
+#include "gl_state.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+// Alignment of every allocation (large enough for any vertex attribute type)
+static const GLsizeiptr STREAM_ALIGNMENT = 16;
+
+// Instantiate static variables
+std::vector<StreamBuffer *> StreamBuffer::buffers;
+
+
+StreamBuffer::StreamBuffer(GLenum target, GLsizeiptr partitionSize)
+    : Buffer(GenBuffer()), Target(target), PartitionSize(partitionSize), Persistent(GLEW_ARB_buffer_storage), partition(0), used(0), frameStarted(GL_FALSE), persistentData(nullptr)
+{
+    for (GLsync &fence : this->fences)
+        fence = 0;
+    GLState::BindBuffer(target, this->Buffer.ID);
+    if (this->Persistent)
+    {
+        // Immutable storage for all partitions, mapped once for the lifetime of the buffer
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(target, partitionSize * STREAM_BUFFER_PARTITIONS, NULL, flags);
+        this->persistentData = static_cast<char *>(glMapBufferRange(target, 0, partitionSize * STREAM_BUFFER_PARTITIONS, flags));
+        if (this->persistentData == nullptr)
+        {
+            // Immutable storage can't be respecified, so replace the buffer and take the orphaning path instead
+            std::cout << "ERROR::STREAMBUFFER: Failed to map persistent buffer storage, orphaning instead" << std::endl;
+            this->Buffer = GenBuffer();
+            GLState::BindBuffer(target, this->Buffer.ID);
+            this->Persistent = GL_FALSE;
+        }
+    }
+    if (!this->Persistent)
+        glBufferData(target, partitionSize, NULL, GL_STREAM_DRAW);
+    buffers.push_back(this);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    buffers.erase(std::remove(buffers.begin(), buffers.end(), this), buffers.end());
+    for (GLsync fence : this->fences)
+        if (fence)
+            glDeleteSync(fence);
+    if (this->persistentData)
+    {
+        GLState::BindBuffer(this->Target, this->Buffer.ID);
+        glUnmapBuffer(this->Target);
+    }
+}
+
+void *StreamBuffer::Map(GLsizeiptr size, GLintptr &offset)
+{
+    if (!this->frameStarted)
+        this->beginFrame();
+    GLsizeiptr start = (this->used + STREAM_ALIGNMENT - 1) / STREAM_ALIGNMENT * STREAM_ALIGNMENT;
+    if (start + size > this->PartitionSize)
+    {
+        if (this->Persistent)
+        {
+            // The other partitions may still be read by the GPU; never wait on them
+            std::cout << "ERROR::STREAMBUFFER: Frame partition exhausted, dropping " << size << " bytes" << std::endl;
+            return nullptr;
+        }
+        // Fallback path: simply orphan again and start over in fresh storage
+        this->beginFrame();
+        start = 0;
+        if (size > this->PartitionSize)
+            return nullptr;
+    }
+    this->used = start + size;
+    if (this->Persistent)
+    {
+        offset = this->partition * this->PartitionSize + start;
+        return this->persistentData + offset;
+    }
+    offset = start;
+    GLState::BindBuffer(this->Target, this->Buffer.ID);
+    // The range hasn't been used since the storage was orphaned, so no synchronization is needed
+    return glMapBufferRange(this->Target, start, size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+}
+
+void StreamBuffer::Unmap()
+{
+    // Persistent mappings are coherent and stay mapped
+    if (!this->Persistent)
+    {
+        GLState::BindBuffer(this->Target, this->Buffer.ID);
+        glUnmapBuffer(this->Target);
+    }
+}
+
+void StreamBuffer::EndFrame()
+{
+    for (StreamBuffer *buffer : buffers)
+        buffer->endFrame();
+}
+
+void StreamBuffer::beginFrame()
+{
+    if (this->Persistent)
+    {
+        // The fence was placed STREAM_BUFFER_PARTITIONS frames ago, so it has almost always signaled already
+        GLsync &fence = this->fences[this->partition];
+        if (fence)
+        {
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+                ;
+            glDeleteSync(fence);
+            fence = 0;
+        }
+    }
+    else
+    {
+        GLState::BindBuffer(this->Target, this->Buffer.ID);
+        glBufferData(this->Target, this->PartitionSize, NULL, GL_STREAM_DRAW);
+    }
+    this->used = 0;
+    this->frameStarted = GL_TRUE;
+}
+
+void StreamBuffer::endFrame()
+{
+    if (!this->frameStarted)
+        return; // Nothing was written this frame
+    if (this->Persistent)
+    {
+        this->fences[this->partition] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        this->partition = (this->partition + 1) % STREAM_BUFFER_PARTITIONS;
+    }
+    this->frameStarted = GL_FALSE;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "gl_object.hpp"
+
+
+// Number of frames that can be in flight at once; each one writes to its own partition
+const GLuint STREAM_BUFFER_PARTITIONS = 3;
+
+// StreamBuffer is a ring buffer for vertex data that is rewritten
+// every frame. With ARB_buffer_storage it is mapped persistently
+// and split into one partition per in-flight frame, guarded by a
+// fence, so CPU writes never wait on draws still reading the data.
+// Without it, the storage is orphaned at the start of every frame
+// and written through unsynchronized mappings.
+// Call StreamBuffer::EndFrame() once after the last draw of a frame.
+class StreamBuffer
+{
+public:
+    // State
+    BufferObject Buffer;
+    GLenum       Target;
+    GLsizeiptr   PartitionSize; // Bytes available per frame
+    GLboolean    Persistent;    // Whether the persistent-mapping path is used
+    // Constructor/Destructor (registered by address, so it can't be copied)
+    StreamBuffer(GLenum target, GLsizeiptr partitionSize);
+    ~StreamBuffer();
+    StreamBuffer(const StreamBuffer &) = delete;
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+    // Maps size bytes of this frame's partition for writing and stores their offset within the buffer (nullptr if the partition is full)
+    void *Map(GLsizeiptr size, GLintptr &offset);
+    // Finishes writing the data returned by Map; must be called before the data is drawn
+    void  Unmap();
+    // Fences the current partition of all stream buffers and moves on to the next one
+    static void EndFrame();
+private:
+    // Ring state
+    GLuint     partition;      // Partition written this frame
+    GLsizeiptr used;           // Bytes used within that partition
+    GLboolean  frameStarted;   // Whether the partition has been made writable this frame
+    GLsync     fences[STREAM_BUFFER_PARTITIONS];
+    char      *persistentData; // Base pointer of the persistent mapping
+    // All live stream buffers, so frames can be ended for every one of them at once
+    static std::vector<StreamBuffer *> buffers;
+    // Waits until the GPU is done with the current partition (persistent) or orphans the storage (fallback)
+    void beginFrame();
+    void endFrame();
+};
+
+#endif
\ No newline at end of file
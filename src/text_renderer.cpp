@@ -6,6 +6,7 @@
 ** Creative Commons, either version 4 of the License, or (at your
 ** option) any later version.
 ******************************************************************/
+#include <cstring>
 #include <iostream>
 
 #include <glm/gtc/matrix_transform.hpp>
@@ -14,44 +15,58 @@
 
 #include "text_renderer.hpp"
 #include "resource_manager.hpp"
+#include "gl_state.hpp"
 
+// Bytes of glyph vertices the text renderer can stream per frame
+static const GLsizeiptr TEXT_STREAM_SIZE = 256 * 1024;
 
-TextRenderer::TextRenderer(GLuint width, GLuint height)
+
+TextRenderer::TextRenderer()
+    : TextShader(ResourceManager::LoadShader("shaders/text.vert", "shaders/text.frag", nullptr, "text")), vertexStream(GL_ARRAY_BUFFER, TEXT_STREAM_SIZE)
 {
-    // Load and configure shader
-    this->TextShader = ResourceManager::LoadShader("shaders/text.vert", "shaders/text.frag", nullptr, "text");
-    this->TextShader.SetMatrix4("projection", glm::ortho(0.0f, static_cast<GLfloat>(width), static_cast<GLfloat>(height), 0.0f), GL_TRUE);
-    this->TextShader.SetInteger("text", 0);
-    // Configure VAO/VBO for texture quads
-    glGenVertexArrays(1, &this->VAO);
-    glGenBuffers(1, &this->VBO);
-    glBindVertexArray(this->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+    // Configure shader (projection comes from the per-frame uniform block)
+    this->TextShader.SetInteger("text", 0, GL_TRUE);
+    this->colorUniform = this->TextShader.Uniform("textColor");
+    // Configure VAO for texture quads (vertices are streamed per string)
+    this->VAO = GenVertexArray();
+    GLState::BindVertexArray(this->VAO.ID);
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
 }
 
 void TextRenderer::Load(std::string font, GLuint fontSize)
 {
     // First clear the previously loaded Characters
     this->Characters.clear();
-    // Then initialize and load the FreeType library
+    this->glyphTextures.clear();
+    // Then for the first 128 ASCII characters, pre-load/compile their characters and store them
+    std::vector<GlyphBitmap> glyphs;
+    Rasterize(font, fontSize, 0, 128, glyphs); // lol see what I did there 
+    this->Upload(glyphs);
+}
+
+GLboolean TextRenderer::Rasterize(const std::string &font, GLuint fontSize, GLuint first, GLuint last, std::vector<GlyphBitmap> &glyphs)
+{
+    // Initialize and load the FreeType library (a library and its faces must not be shared between threads)
     FT_Library ft;    
     if (FT_Init_FreeType(&ft)) // All functions return a value different than 0 whenever an error occurred
+    {
         std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
-    // Load font as face
+        return GL_FALSE;
+    }
+    // Load font as face (straight from memory; it only has to live until the glyphs are rasterised below)
+    AssetView fontData;
+    if (!ResourceManager::ReadAsset(font, fontData))
+        std::cout << "ERROR::FREETYPE: Failed to read font " << font << std::endl;
     FT_Face face;
-    if (FT_New_Face(ft, font.c_str(), 0, &face))
+    if (FT_New_Memory_Face(ft, fontData.Data, static_cast<FT_Long>(fontData.Size), 0, &face))
+    {
         std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
+        FT_Done_FreeType(ft);
+        return GL_FALSE;
+    }
     // Set size to load glyphs as
     FT_Set_Pixel_Sizes(face, 0, fontSize);
-    // Disable byte-alignment restriction
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); 
-    // Then for the first 128 ASCII characters, pre-load/compile their characters and store them
-    for (GLubyte c = 0; c < 128; c++) // lol see what I did there 
+    for (GLuint c = first; c < last; c++)
     {
         // Load character glyph 
         if (FT_Load_Char(face, c, FT_LOAD_RENDER))
@@ -59,20 +74,44 @@ void TextRenderer::Load(std::string font, GLuint fontSize)
             std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
             continue;
         }
+        // Keep a copy of the bitmap (FreeType reuses it for the next glyph)
+        FT_Bitmap &bitmap = face->glyph->bitmap;
+        GlyphBitmap glyph;
+        glyph.Code = static_cast<GLchar>(c);
+        glyph.Metrics.TextureID = 0;
+        glyph.Metrics.Size = glm::ivec2(bitmap.width, bitmap.rows);
+        glyph.Metrics.Bearing = glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top);
+        glyph.Metrics.Advance = face->glyph->advance.x;
+        for (GLuint row = 0; row < bitmap.rows; ++row)
+            glyph.Pixels.insert(glyph.Pixels.end(), bitmap.buffer + row * bitmap.pitch, bitmap.buffer + row * bitmap.pitch + bitmap.width);
+        glyphs.push_back(glyph);
+    }
+    // Destroy FreeType once we're finished
+    FT_Done_Face(face);
+    FT_Done_FreeType(ft);
+    return GL_TRUE;
+}
+
+void TextRenderer::Upload(const std::vector<GlyphBitmap> &glyphs)
+{
+    // Disable byte-alignment restriction
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); 
+    for (const GlyphBitmap &glyph : glyphs)
+    {
         // Generate texture
-        GLuint texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        this->glyphTextures.push_back(GenTexture());
+        GLuint texture = this->glyphTextures.back().ID;
+        GLState::BindTexture(GL_TEXTURE_2D, texture);
         glTexImage2D(
             GL_TEXTURE_2D,
             0,
             GL_RED,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
+            glyph.Metrics.Size.x,
+            glyph.Metrics.Size.y,
             0,
             GL_RED,
             GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer
+            glyph.Pixels.empty() ? nullptr : glyph.Pixels.data()
             );
         // Set texture options
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -81,31 +120,25 @@ void TextRenderer::Load(std::string font, GLuint fontSize)
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
        
         // Now store character for later use
-        Character character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            face->glyph->advance.x
-        };
-        Characters.insert(std::pair<GLchar, Character>(c, character));
+        Character character = glyph.Metrics;
+        character.TextureID = texture;
+        Characters.insert(std::pair<GLchar, Character>(glyph.Code, character));
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
-    // Destroy FreeType once we're finished
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
 }
 
 void TextRenderer::RenderText(std::string text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 color)
 {
-    // Activate corresponding render state	
-    this->TextShader.Use();
-    this->TextShader.SetVector3f("textColor", color);
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(this->VAO);
-
-    // Iterate through all characters
+    if (text.empty())
+        return;
+    // Write the quads of all characters into the vertex stream at once
+    typedef GLfloat Quad[6][4];
+    GLintptr offset;
+    Quad *quads = static_cast<Quad *>(this->vertexStream.Map(text.size() * sizeof(Quad), offset));
+    if (quads == nullptr)
+        return;
     std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); c++)
+    GLuint i = 0;
+    for (c = text.begin(); c != text.end(); c++, i++)
     {
         Character ch = Characters[*c];
 
@@ -114,7 +147,6 @@ void TextRenderer::RenderText(std::string text, GLfloat x, GLfloat y, GLfloat sc
 
         GLfloat w = ch.Size.x * scale;
         GLfloat h = ch.Size.y * scale;
-        // Update VBO for each character
         GLfloat vertices[6][4] = {
             { xpos,     ypos + h,   0.0, 1.0 },
             { xpos + w, ypos,       1.0, 0.0 },
@@ -124,18 +156,24 @@ void TextRenderer::RenderText(std::string text, GLfloat x, GLfloat y, GLfloat sc
             { xpos + w, ypos + h,   1.0, 1.0 },
             { xpos + w, ypos,       1.0, 0.0 }
         };
-        // Render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        // Update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); // Be sure to use glBufferSubData and not glBufferData
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // Render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        std::memcpy(quads[i], vertices, sizeof(Quad));
         // Now advance cursors for next glyph
         x += (ch.Advance >> 6) * scale; // Bitshift by 6 to get value in pixels (1/64th times 2^6 = 64)
     }
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    this->vertexStream.Unmap();
+
+    // Activate corresponding render state	
+    this->TextShader.Use();
+    this->TextShader.SetVector3f(this->colorUniform, color);
+    GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindVertexArray(this->VAO.ID);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->vertexStream.Buffer.ID);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid*)offset);
+    // Render each glyph texture over its quad
+    for (i = 0, c = text.begin(); c != text.end(); c++, i++)
+    {
+        GLState::BindTexture(GL_TEXTURE_2D, Characters[*c].TextureID);
+        glDrawArrays(GL_TRIANGLES, i * 6, 6);
+    }
 }
\ No newline at end of file
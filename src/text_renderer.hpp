@@ -10,12 +10,16 @@
 #define TEXT_RENDERER_H
 
 #include <map>
+#include <string>
+#include <vector>
 
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
 #include "texture.hpp"
 #include "shader.hpp"
+#include "gl_object.hpp"
+#include "stream_buffer.hpp"
 
 
 /// Holds all state information relevant to a character as loaded using FreeType
@@ -26,6 +30,13 @@ struct Character {
     GLuint Advance;     // Horizontal offset to advance to next glyph
 };
 
+/// A glyph rasterised by FreeType on the CPU, not yet uploaded to a texture
+struct GlyphBitmap {
+    GLchar                     Code;
+    Character                  Metrics; // TextureID is assigned on upload
+    std::vector<unsigned char> Pixels;  // One byte per pixel, rows tightly packed
+};
+
 
 // A renderer class for rendering text displayed by a font loaded using the 
 // FreeType library. A single font is loaded, processed into a list of Character
@@ -35,17 +46,24 @@ class TextRenderer
 public:
     // Holds a list of pre-compiled Characters
     std::map<GLchar, Character> Characters; 
-    // Shader used for text rendering
-    Shader TextShader;
+    // Shader used for text rendering (stored by the ResourceManager)
+    Shader &TextShader;
     // Constructor
-    TextRenderer(GLuint width, GLuint height);
+    TextRenderer();
     // Pre-compiles a list of characters from the given font
     void Load(std::string font, GLuint fontSize);
+    // Rasterises the characters [first, last) of the given font without touching OpenGL, so it may be called from any thread
+    static GLboolean Rasterize(const std::string &font, GLuint fontSize, GLuint first, GLuint last, std::vector<GlyphBitmap> &glyphs);
+    // Generates the textures of rasterised glyphs and adds them to the list of characters
+    void Upload(const std::vector<GlyphBitmap> &glyphs);
     // Renders a string of text using the precompiled list of characters
     void RenderText(std::string text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 color = glm::vec3(1.0f));
 private:
     // Render state
-    GLuint VAO, VBO;
+    VertexArrayObject          VAO;
+    StreamBuffer               vertexStream;  // Per-frame glyph quads
+    std::vector<TextureObject> glyphTextures; // Textures of the Characters
+    GLint                      colorUniform;
 };
 
 #endif 
\ No newline at end of file
@@ -6,15 +6,53 @@
 ** Creative Commons, either version 4 of the License, or (at your
 ** option) any later version.
 ******************************************************************/
+#include <algorithm>
 #include <iostream>
+#include <utility>
 
 #include "texture.hpp"
+#include "gl_state.hpp"
+#include "texture_format.hpp"
 
 
 Texture2D::Texture2D()
-    : Width(0), Height(0), Internal_Format(GL_RGB), Image_Format(GL_RGB), Wrap_S(GL_REPEAT), Wrap_T(GL_REPEAT), Filter_Min(GL_LINEAR), Filter_Max(GL_LINEAR)
+    : ID(0), Width(0), Height(0), Internal_Format(GL_RGB), Image_Format(GL_RGB), Wrap_S(GL_REPEAT), Wrap_T(GL_REPEAT), Filter_Min(GL_LINEAR), Filter_Max(GL_LINEAR), Mipmaps(GL_FALSE), Levels(0), Size(0)
 {
-    glGenTextures(1, &this->ID);
+
+}
+
+Texture2D::~Texture2D()
+{
+    if (this->ID != 0)
+        GLState::DeleteTexture(this->ID);
+}
+
+Texture2D::Texture2D(Texture2D &&other) noexcept
+    : ID(0)
+{
+    *this = std::move(other);
+}
+
+Texture2D &Texture2D::operator=(Texture2D &&other) noexcept
+{
+    if (this == &other)
+        return *this;
+    if (this->ID != 0)
+        GLState::DeleteTexture(this->ID);
+    this->ID = other.ID;
+    this->Width = other.Width;
+    this->Height = other.Height;
+    this->Internal_Format = other.Internal_Format;
+    this->Image_Format = other.Image_Format;
+    this->Wrap_S = other.Wrap_S;
+    this->Wrap_T = other.Wrap_T;
+    this->Filter_Min = other.Filter_Min;
+    this->Filter_Max = other.Filter_Max;
+    this->Mipmaps = other.Mipmaps;
+    this->Levels = other.Levels;
+    this->Size = other.Size;
+    other.ID = 0;
+    return *this;
 }
 
 void Texture2D::Generate(GLuint width, GLuint height, unsigned char* data)
@@ -22,18 +60,60 @@ void Texture2D::Generate(GLuint width, GLuint height, unsigned char* data)
     this->Width = width;
     this->Height = height;
     // Create Texture
-    glBindTexture(GL_TEXTURE_2D, this->ID);
+    if (this->ID == 0)
+        glGenTextures(1, &this->ID);
+    GLState::BindTexture(GL_TEXTURE_2D, this->ID);
     glTexImage2D(GL_TEXTURE_2D, 0, this->Internal_Format, width, height, 0, this->Image_Format, GL_UNSIGNED_BYTE, data);
+    // Drivers pad RGB texels to four bytes, so every texel is counted as RGBA; a mip chain adds a third
+    this->Levels = 1;
+    this->Size = static_cast<GLsizeiptr>(width) * height * 4;
+    if (this->Mipmaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+        while ((std::max(width, height) >> this->Levels) > 0)
+            ++this->Levels;
+        this->Size += this->Size / 3;
+    }
     // Set Texture wrap and filter modes
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, this->Wrap_S);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, this->Wrap_T);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, this->Filter_Min);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, this->Filter_Max);
-    // Unbind texture
-    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Texture2D::GenerateCompressed(GLuint width, GLuint height, GLenum format, GLuint levels, const unsigned char *data)
+{
+    this->Width = width;
+    this->Height = height;
+    this->Internal_Format = format;
+    this->Levels = levels;
+    this->Size = 0;
+    if (this->ID == 0)
+        glGenTextures(1, &this->ID);
+    GLState::BindTexture(GL_TEXTURE_2D, this->ID);
+    for (GLuint level = 0; level < levels; ++level)
+    {
+        GLuint levelWidth = std::max(width >> level, 1u), levelHeight = std::max(height >> level, 1u);
+        GLsizeiptr size = CompressedLevelSize(format, levelWidth, levelHeight);
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, format, levelWidth, levelHeight, 0, static_cast<GLsizei>(size), data + this->Size);
+        this->Size += size;
+    }
+    // Sample only the levels there are (a partial chain would leave the texture incomplete)
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    if (levels == 1 && this->Filter_Min != GL_NEAREST)
+        this->Filter_Min = GL_LINEAR;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, this->Wrap_S);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, this->Wrap_T);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, this->Filter_Min);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, this->Filter_Max);
 }
 
 void Texture2D::Bind() const
 {
-    glBindTexture(GL_TEXTURE_2D, this->ID);
+    GLState::BindTexture(GL_TEXTURE_2D, this->ID);
+}
+
+void TextureView::Bind() const
+{
+    GLState::BindTexture(GL_TEXTURE_2D, this->ID);
 }
\ No newline at end of file
@@ -12,7 +12,10 @@
 #include <GL/glew.h>
 
 // Texture2D is able to store and configure a texture in OpenGL.
-// It also hosts utility functions for easy management.
+// It also hosts utility functions for easy management. It owns its
+// texture object, deleting it when destroyed, so it can be moved but
+// not copied; code using a texture it doesn't own holds a
+// TextureView of it instead.
 class Texture2D
 {
 public:
@@ -28,10 +31,36 @@ public:
     GLuint Wrap_T; // Wrapping mode on T axis
     GLuint Filter_Min; // Filtering mode if texture pixels < screen pixels
     GLuint Filter_Max; // Filtering mode if texture pixels > screen pixels
-    // Constructor (sets default texture modes)
+    GLboolean Mipmaps; // Whether Generate builds a mip chain (Filter_Min should be a mipmap filter then)
+    // Texture memory
+    GLuint     Levels; // Number of mipmap levels
+    GLsizeiptr Size;   // Bytes of all levels
+    // Constructor (sets default texture modes; the texture object is created by the first Generate)/Destructor
     Texture2D();
+    ~Texture2D();
+    Texture2D(Texture2D &&other) noexcept;
+    Texture2D &operator=(Texture2D &&other) noexcept;
+    Texture2D(const Texture2D &) = delete;
+    Texture2D &operator=(const Texture2D &) = delete;
     // Generates texture from image data
     void Generate(GLuint width, GLuint height, unsigned char* data);
+    // Generates texture from block compressed data of the given format (the given number of mipmap levels, largest first)
+    void GenerateCompressed(GLuint width, GLuint height, GLenum format, GLuint levels, const unsigned char *data);
+    // Binds the texture as the current active GL_TEXTURE_2D texture object
+    void Bind() const;
+};
+
+// Non-owning reference to a Texture2D: its texture object and size,
+// cheap to copy (e.g. into every game object drawn with it). A view
+// doesn't keep its texture alive, so the texture must outlive it.
+class TextureView
+{
+public:
+    GLuint ID;
+    GLuint Width, Height;
+    // Constructors (an empty view, or one of the given texture)
+    TextureView() : ID(0), Width(0), Height(0) { }
+    TextureView(const Texture2D &texture) : ID(texture.ID), Width(texture.Width), Height(texture.Height) { }
     // Binds the texture as the current active GL_TEXTURE_2D texture object
     void Bind() const;
 };
@@ -0,0 +1,55 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef TEXTURE_FORMAT_H
+#define TEXTURE_FORMAT_H
+
+#include <GL/glew.h>
+extern "C" {
+#include <image_DXT.h> // DDS_header and its flags (shipped with SOIL)
+}
+
+
+// Identifies a DDS file ("DDS ")
+const GLuint DDS_MAGIC = 0x20534444;
+// Pixel format four character codes of the block compressed formats
+const GLuint DDS_FOURCC_DXT1 = 0x31545844; // "DXT1": BC1, RGB
+const GLuint DDS_FOURCC_DXT5 = 0x35545844; // "DXT5": BC3, RGBA
+const GLuint DDS_FOURCC_DX10 = 0x30315844; // "DX10": a DdsHeaderDX10 naming the format follows the header
+// Formats of the DX10 header that are read
+const GLuint DXGI_FORMAT_BC1_UNORM = 71;
+const GLuint DXGI_FORMAT_BC3_UNORM = 77;
+const GLuint DXGI_FORMAT_BC7_UNORM = 98;
+
+// Layout of a compressed texture (.dds, written by the texture
+// converter tool): the DDS_header, for formats without a four
+// character code of their own (BC7) a DdsHeaderDX10, and then the
+// blocks of every mipmap level, largest first. Rows are stored in
+// the order the images decode in (top row first), as the textures
+// loaded from the images themselves.
+struct DdsHeaderDX10 {
+    GLuint DxgiFormat;
+    GLuint ResourceDimension;
+    GLuint MiscFlag;
+    GLuint ArraySize;
+    GLuint MiscFlags2;
+};
+
+// Bytes per 4x4 block of the given compressed format
+inline GLuint CompressedBlockSize(GLenum format)
+{
+    return format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? 8 : 16;
+}
+
+// Bytes of a mipmap level of the given size in a compressed format (partial blocks at the edges are whole blocks)
+inline GLsizeiptr CompressedLevelSize(GLenum format, GLuint width, GLuint height)
+{
+    return static_cast<GLsizeiptr>((width + 3) / 4) * ((height + 3) / 4) * CompressedBlockSize(format);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+
+ThreadPool::ThreadPool(GLuint threads)
+    : stopping(GL_FALSE)
+{
+    if (threads == 0)
+        threads = std::max(1, static_cast<GLint>(std::thread::hardware_concurrency()) - 1);
+    for (GLuint i = 0; i < threads; ++i)
+        this->workers.push_back(std::thread(&ThreadPool::work, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = GL_TRUE;
+        this->tasks.clear();
+    }
+    this->submitted.notify_all();
+    for (std::thread &worker : this->workers)
+        worker.join();
+}
+
+GLuint ThreadPool::Size() const
+{
+    return this->workers.size();
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->tasks.push_back(task);
+    }
+    this->submitted.notify_one();
+}
+
+void ThreadPool::work()
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (true)
+    {
+        this->submitted.wait(lock, [this] { return this->stopping || !this->tasks.empty(); });
+        if (this->stopping)
+            return;
+        std::function<void()> task = this->tasks.front();
+        this->tasks.pop_front();
+        // Run the task without holding the lock, so the other workers can pick up tasks meanwhile
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <GL/glew.h>
+
+
+// A fixed set of worker threads running submitted tasks in FIFO
+// order. Tasks must not touch OpenGL: no context is current on
+// the workers. Tasks that have not started when the pool is
+// destroyed are discarded.
+class ThreadPool
+{
+public:
+    // Constructor/Destructor (0 threads: one per hardware thread besides the calling one, at least one)
+    ThreadPool(GLuint threads = 0);
+    ~ThreadPool();
+    // Number of worker threads
+    GLuint Size() const;
+    // Queues a task for the next idle worker
+    void   Submit(std::function<void()> task);
+private:
+    std::vector<std::thread>          workers;
+    std::mutex                        mutex;
+    std::condition_variable           submitted;
+    std::deque<std::function<void()>> tasks;
+    GLboolean                         stopping;
+    // Worker thread: runs tasks until the pool is stopping
+    void work();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "uniform_buffer.hpp"
+
+#include <cstring>
+
+#include "gl_state.hpp"
+
+
+UniformBuffer::UniformBuffer(GLuint binding, GLsizeiptr size)
+    : Buffer(GenBuffer()), Binding(binding), Size(size), shadow(size), valid(GL_FALSE)
+{
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, this->Buffer.ID);
+    glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+    // Attach the buffer once; programs refer to it through their block binding
+    GLState::BindBufferBase(GL_UNIFORM_BUFFER, binding, this->Buffer.ID);
+}
+
+void UniformBuffer::Update(const void *data)
+{
+    if (this->valid && std::memcmp(this->shadow.data(), data, this->Size) == 0)
+        return;
+    std::memcpy(this->shadow.data(), data, this->Size);
+    this->valid = GL_TRUE;
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, this->Buffer.ID);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, this->Size, data);
+}
\ No newline at end of file
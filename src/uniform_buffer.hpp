@@ -0,0 +1,56 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef UNIFORM_BUFFER_H
+#define UNIFORM_BUFFER_H
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "gl_object.hpp"
+
+
+// Name of the per-frame uniform block declared by the shaders
+#define FRAME_UNIFORM_BLOCK "Frame"
+// Binding point the per-frame uniform block is attached to in every program
+const GLuint FRAME_UNIFORM_BINDING = 0;
+
+// Mirrors the std140 layout of the per-frame uniform block:
+// data that is identical for every draw call within a frame.
+struct FrameUniforms {
+    glm::mat4 Projection;
+    glm::mat4 View;       // Camera offset of the scene (sprites and particles; text is drawn in screen space)
+    GLfloat   Time;
+    GLfloat   Padding[3]; // std140 rounds the block size up to a multiple of 16 bytes
+};
+
+
+// UniformBuffer hosts a uniform buffer object bound to a fixed
+// binding point so its contents are visible to all programs at
+// once. Uploads that don't change the contents are skipped.
+class UniformBuffer
+{
+public:
+    // State
+    BufferObject Buffer;
+    GLuint       Binding;
+    GLsizeiptr   Size;
+    // Constructor (the buffer is deleted along with the object; it can't be copied)
+    UniformBuffer(GLuint binding, GLsizeiptr size);
+    UniformBuffer(const UniformBuffer &) = delete;
+    UniformBuffer &operator=(const UniformBuffer &) = delete;
+    // Uploads Size bytes of data to the buffer (if they differ from the current contents)
+    void Update(const void *data);
+private:
+    // Copy of the current buffer contents
+    std::vector<unsigned char> shadow;
+    GLboolean                  valid;
+};
+
+#endif
\ No newline at end of file
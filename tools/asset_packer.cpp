@@ -0,0 +1,135 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+// Builds an asset pack (see src/asset_pack.hpp) from a list of files.
+// Usage: asset_packer [--lz4] [--root DIR] OUTPUT FILE...
+// Entries are named by their path relative to the root directory
+// (the current directory by default), e.g. "assets/levels/01_one.lvl".
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#ifdef BREAKOUT_LZ4
+#include <lz4.h>
+#endif
+
+#include "src/asset_pack.hpp"
+
+
+// Entries compressing to more than this fraction of their size are stored (PNG, JPEG and MP3 are compressed already)
+const GLfloat PACK_COMPRESSION_THRESHOLD = 0.9f;
+
+struct PackInput {
+    PackEntry                  Entry;
+    std::vector<unsigned char> Data;
+};
+
+int main(int argc, char *argv[])
+{
+    GLboolean lz4 = GL_FALSE;
+    std::string root, output;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--lz4")
+            lz4 = GL_TRUE;
+        else if (arg == "--root" && i + 1 < argc)
+            root = std::string(argv[++i]) + "/";
+        else if (output.empty())
+            output = arg;
+        else
+            files.push_back(arg);
+    }
+    if (output.empty())
+    {
+        std::cout << "Usage: asset_packer [--lz4] [--root DIR] OUTPUT FILE..." << std::endl;
+        return 1;
+    }
+#ifndef BREAKOUT_LZ4
+    if (lz4)
+    {
+        std::cout << "ERROR::PACKER: --lz4 requires a build with BREAKOUT_LZ4 enabled" << std::endl;
+        return 1;
+    }
+#endif
+
+    // Read every file (sorted by path, as the runtime looks entries up by binary search)
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+    std::vector<PackInput> inputs(files.size());
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        PackInput &input = inputs[i];
+        std::memset(&input.Entry, 0, sizeof(PackEntry));
+        if (files[i].size() >= PACK_PATH_LENGTH)
+        {
+            std::cout << "ERROR::PACKER: Path too long: " << files[i] << std::endl;
+            return 1;
+        }
+        std::strcpy(input.Entry.Path, files[i].c_str());
+        std::ifstream file((root + files[i]).c_str(), std::ios::in | std::ios::binary);
+        if (!file)
+        {
+            std::cout << "ERROR::PACKER: Failed to read " << root + files[i] << std::endl;
+            return 1;
+        }
+        input.Data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        input.Entry.Size = input.Entry.OriginalSize = input.Data.size();
+        input.Entry.Compression = PACK_STORED;
+#ifdef BREAKOUT_LZ4
+        if (lz4 && !input.Data.empty())
+        {
+            std::vector<unsigned char> compressed(LZ4_compressBound(static_cast<int>(input.Data.size())));
+            int size = LZ4_compress_default(reinterpret_cast<const char*>(input.Data.data()), reinterpret_cast<char*>(compressed.data()),
+                static_cast<int>(input.Data.size()), static_cast<int>(compressed.size()));
+            if (size > 0 && size < input.Data.size() * PACK_COMPRESSION_THRESHOLD)
+            {
+                compressed.resize(size);
+                input.Data.swap(compressed);
+                input.Entry.Size = size;
+                input.Entry.Compression = PACK_LZ4;
+            }
+        }
+#endif
+    }
+    // Lay the data out after the index, each entry aligned and followed by a terminating zero
+    GLuint64 offset = sizeof(PackHeader) + inputs.size() * sizeof(PackEntry);
+    for (PackInput &input : inputs)
+    {
+        offset = (offset + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+        input.Entry.Offset = offset;
+        offset += input.Entry.Size + 1;
+    }
+
+    std::ofstream pack(output.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    PackHeader header = { PACK_MAGIC, PACK_VERSION, static_cast<GLuint>(inputs.size()), 0 };
+    pack.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const PackInput &input : inputs)
+        pack.write(reinterpret_cast<const char*>(&input.Entry), sizeof(PackEntry));
+    GLuint64 stored = 0, original = 0;
+    for (const PackInput &input : inputs)
+    {
+        static const char padding[PACK_ALIGNMENT] = { 0 };
+        pack.write(padding, static_cast<std::streamsize>(input.Entry.Offset - pack.tellp()));
+        pack.write(reinterpret_cast<const char*>(input.Data.data()), input.Data.size());
+        pack.put('\0');
+        stored += input.Entry.Size;
+        original += input.Entry.OriginalSize;
+    }
+    if (!pack)
+    {
+        std::cout << "ERROR::PACKER: Failed to write " << output << std::endl;
+        return 1;
+    }
+    std::cout << "INFO::PACKER: Packed " << inputs.size() << " assets (" << original << " bytes, " << stored << " stored) into " << output << std::endl;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+// Converts a text level (.lvl) into a binary level (see src/level_format.hpp).
+// Usage: level_converter [--colors FILE] INPUT.lvl OUTPUT.blvl
+// The optional color file holds a row per level row with an RRGGBB
+// hex color (or - for the default color of the tile code) per tile.
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "src/level_format.hpp"
+
+
+// Reads whitespace separated words per line; rows without words are skipped
+std::vector<std::vector<std::string>> read_rows(const std::string &path)
+{
+    std::vector<std::vector<std::string>> rows;
+    std::ifstream file(path.c_str());
+    std::string line, word;
+    while (std::getline(file, line))
+    {
+        std::istringstream words(line);
+        std::vector<std::string> row;
+        while (words >> word)
+            row.push_back(word);
+        if (!row.empty())
+            rows.push_back(row);
+    }
+    return rows;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string colorFile, input, output;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--colors" && i + 1 < argc)
+            colorFile = argv[++i];
+        else if (input.empty())
+            input = arg;
+        else
+            output = arg;
+    }
+    if (output.empty())
+    {
+        std::cout << "Usage: level_converter [--colors FILE] INPUT.lvl OUTPUT.blvl" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::vector<std::string>> rows = read_rows(input);
+    if (rows.empty())
+    {
+        std::cout << "ERROR::CONVERTER: No tiles in " << input << std::endl;
+        return 1;
+    }
+    LevelHeader header = { LEVEL_MAGIC, LEVEL_VERSION, static_cast<GLuint>(rows[0].size()), static_cast<GLuint>(rows.size()), 0, 0 };
+    // Tile codes, row by row (rows are cut or padded to the width of the first)
+    std::vector<GLubyte> tiles(header.Width * header.Height, 0);
+    for (GLuint y = 0; y < header.Height; ++y)
+        for (GLuint x = 0; x < header.Width && x < rows[y].size(); ++x)
+            tiles[y * header.Width + x] = static_cast<GLubyte>(std::atoi(rows[y][x].c_str()));
+    // Optional colors
+    std::vector<LevelTileColor> colors;
+    if (!colorFile.empty())
+    {
+        std::vector<std::vector<std::string>> colorRows = read_rows(colorFile);
+        LevelTileColor none = { 0, 0, 0, 0 };
+        colors.assign(tiles.size(), none);
+        for (GLuint y = 0; y < header.Height && y < colorRows.size(); ++y)
+            for (GLuint x = 0; x < header.Width && x < colorRows[y].size(); ++x)
+                if (colorRows[y][x] != "-")
+                {
+                    GLuint rgb = std::strtoul(colorRows[y][x].c_str(), nullptr, 16);
+                    LevelTileColor color = { static_cast<GLubyte>(rgb >> 16), static_cast<GLubyte>(rgb >> 8), static_cast<GLubyte>(rgb), 255 };
+                    colors[y * header.Width + x] = color;
+                }
+        header.Flags |= LEVEL_TILE_COLORS;
+    }
+
+    std::ofstream file(output.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(tiles.data()), tiles.size());
+    if (!colors.empty())
+    {
+        static const char padding[4] = { 0 };
+        file.write(padding, LevelColorOffset(tiles.size()) - sizeof(header) - tiles.size());
+        file.write(reinterpret_cast<const char*>(colors.data()), colors.size() * sizeof(LevelTileColor));
+    }
+    if (!file)
+    {
+        std::cout << "ERROR::CONVERTER: Failed to write " << output << std::endl;
+        return 1;
+    }
+    std::cout << "INFO::CONVERTER: Converted " << header.Width << "x" << header.Height << " tiles into " << output << std::endl;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+// Converts an image (PNG, JPEG, ...) into a block compressed texture
+// with a full mip chain (see src/texture_format.hpp).
+// Usage: texture_converter INPUT OUTPUT.dds
+// Images with a translucent texel are stored as DXT5 (BC3), all
+// others as DXT1 (BC1), with SOIL's compressor.
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <stb_image_aug.h>
+
+#include "src/texture_format.hpp"
+
+
+// Halves an RGBA image (rounding down, to at least one texel) by averaging each 2x2 block; an odd last row or column is folded into its neighbours
+std::vector<unsigned char> downsample(const std::vector<unsigned char> &image, GLuint width, GLuint height, GLuint &halfWidth, GLuint &halfHeight)
+{
+    halfWidth = std::max(width / 2, 1u);
+    halfHeight = std::max(height / 2, 1u);
+    std::vector<unsigned char> half(halfWidth * halfHeight * 4);
+    for (GLuint y = 0; y < halfHeight; ++y)
+        for (GLuint x = 0; x < halfWidth; ++x)
+            for (GLuint channel = 0; channel < 4; ++channel)
+            {
+                GLuint sum = 0, count = 0;
+                for (GLuint sy = y * 2; sy < std::min(y * 2 + 2, height); ++sy)
+                    for (GLuint sx = x * 2; sx < std::min(x * 2 + 2, width); ++sx, ++count)
+                        sum += image[(sy * width + sx) * 4 + channel];
+                half[(y * halfWidth + x) * 4 + channel] = static_cast<unsigned char>((sum + count / 2) / count);
+            }
+    return half;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        std::cout << "Usage: texture_converter INPUT OUTPUT.dds" << std::endl;
+        return 1;
+    }
+    int width, height, channels;
+    unsigned char *pixels = stbi_load(argv[1], &width, &height, &channels, 4);
+    if (pixels == nullptr)
+    {
+        std::cout << "ERROR::TEXTURECONVERTER: Failed to decode " << argv[1] << std::endl;
+        return 1;
+    }
+    std::vector<unsigned char> image(pixels, pixels + width * height * 4);
+    stbi_image_free(pixels);
+    GLboolean translucent = GL_FALSE;
+    for (std::size_t i = 3; i < image.size() && !translucent; i += 4)
+        translucent = image[i] != 255;
+
+    // Compress every level down to 1x1
+    std::vector<unsigned char> blocks;
+    GLuint levels = 0, levelWidth = width, levelHeight = height;
+    while (true)
+    {
+        int size;
+        unsigned char *compressed = translucent ? convert_image_to_DXT5(image.data(), levelWidth, levelHeight, 4, &size)
+                                                : convert_image_to_DXT1(image.data(), levelWidth, levelHeight, 4, &size);
+        blocks.insert(blocks.end(), compressed, compressed + size);
+        std::free(compressed);
+        ++levels;
+        if (levelWidth == 1 && levelHeight == 1)
+            break;
+        image = downsample(image, levelWidth, levelHeight, levelWidth, levelHeight);
+    }
+
+    DDS_header header;
+    std::memset(&header, 0, sizeof(header));
+    header.dwMagic = DDS_MAGIC;
+    header.dwSize = sizeof(header) - sizeof(header.dwMagic);
+    header.dwFlags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE | DDSD_MIPMAPCOUNT;
+    header.dwWidth = width;
+    header.dwHeight = height;
+    GLenum format = translucent ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    header.dwPitchOrLinearSize = static_cast<unsigned int>(CompressedLevelSize(format, width, height));
+    header.dwMipMapCount = levels;
+    header.sPixelFormat.dwSize = sizeof(header.sPixelFormat);
+    header.sPixelFormat.dwFlags = DDPF_FOURCC;
+    header.sPixelFormat.dwFourCC = translucent ? DDS_FOURCC_DXT5 : DDS_FOURCC_DXT1;
+    header.sCaps.dwCaps1 = DDSCAPS_TEXTURE | DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+
+    std::ofstream output(argv[2], std::ios::out | std::ios::binary);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(blocks.data()), blocks.size());
+    if (!output)
+    {
+        std::cout << "ERROR::TEXTURECONVERTER: Failed to write " << argv[2] << std::endl;
+        return 1;
+    }
+    std::cout << "Converted " << argv[1] << " (" << width << "x" << height << ", " << levels << " levels, "
+        << (translucent ? "DXT5" : "DXT1") << ", " << blocks.size() << " bytes)" << std::endl;
+    return 0;
+}
\ No newline at end of file